@@ -17,7 +17,15 @@
 // STL
 #include <cassert>
 #include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
+#include <limits>
+#include <utility>
+
+// Project
+#include "Convolution.h"
+#include "Histogram.h"
 
 // OpenCV
 #ifdef WIN32
@@ -26,91 +34,1554 @@
     #include <highgui.h>
 #endif
 
+// SIMD (SSE2 is always available on x86-64)
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+    #define ALGORITHM_USE_SSE
+    #include <emmintrin.h>
+#endif
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+// STL
+using namespace std;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+ 
+/**
+ * percentage of show pixels
+ */
+//float algorithm::percent = 80.0f;
+
+/**
+ * percentage of the high Threshold
+ */
+float algorithm::_highThresholdPercent = 60.0f;
+
+/**
+ * percentage of the low Threshold
+ */
+float algorithm::_lowThresholdPercent = 92.0f;
+
+/**
+ * Ratio of the low threshold to the high (Otsu) threshold of the automatic hysteresis threshold
+ */
+float algorithm::_otsuHysteresisLowRatio = 0.5f;
+
+/**
+ * Number of bins of the histograms used by threshold methods (over [0,256[)
+ */
+int algorithm::_histogramNbBins = 4096;
+
+/**
+ * Flag telling whether or not to approximate the square root of the L2 norm
+ */
+bool algorithm::_useFastL2Norm = false;
+
+/**
+ * Flag telling whether or not to process the hysteresis threshold with bands of lines in parallel
+ */
+bool algorithm::_useParallelHysteresis = false;
+
+/**
+ * Flag telling whether or not to extract edges with connected components traced in parallel
+ */
+bool algorithm::_useParallelEdgeExtraction = false;
+
+/**
+ * Max angle (in degrees) between the tangent at an end of an edge and the gap to bridge
+ */
+float algorithm::_edgeClosureMaxAngle = 45.0f;
+
+/**
+ * Min length (in pixels) of an edge
+ */
+int algorithm::_edgeMinLength = 0;
+
+/**
+ * Min contrast (mean module) of an edge
+ */
+float algorithm::_edgeMinContrast = 0.0f;
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+#define PI 3.14159265
+
+namespace
+{
+#ifdef ALGORITHM_USE_SSE
+
+/**
+ * Absolute value of 4 values (sign bit cleared)
+ *
+ * @param value input values
+ *
+ * @return the absolute values
+ */
+inline __m128 absolute( __m128 value )
+{
+    return _mm_andnot_ps( _mm_set1_ps( -0.0f ), value );
+}
+
+/**
+ * Square root of 4 values
+ * - exact square root, or
+ * - fast approximation (reciprocal square root refined by one Newton step)
+ *
+ * @param value input values (positive)
+ * @param fast flag telling whether or not to approximate the square root
+ *
+ * @return the square roots
+ */
+inline __m128 squareRoot( __m128 value, bool fast )
+{
+    if ( ! fast ) {
+        return _mm_sqrt_ps( value );
+    }
+
+    // sqrt( v ) = v * rsqrt( v ), with rsqrt refined by one Newton step
+    __m128 inverse = _mm_rsqrt_ps( value );
+    inverse = _mm_mul_ps( inverse, _mm_sub_ps( _mm_set1_ps( 1.5f ), _mm_mul_ps( _mm_mul_ps( _mm_set1_ps( 0.5f ), value ), _mm_mul_ps( inverse, inverse ) ) ) );
+
+    // Null values would give NaN
+    return _mm_and_ps( _mm_mul_ps( value, inverse ), _mm_cmpgt_ps( value, _mm_setzero_ps() ) );
+}
+
+/**
+ * Select 4 values given a mask (blend)
+ *
+ * @param mask mask of the values to select in the first input
+ * @param value1 first input (selected where mask is set)
+ * @param value2 second input (selected elsewhere)
+ *
+ * @return the selected values
+ */
+inline __m128 select( __m128 mask, __m128 value1, __m128 value2 )
+{
+    return _mm_or_ps( _mm_and_ps( mask, value1 ), _mm_andnot_ps( mask, value2 ) );
+}
+
+#endif
+
+/**
+ * Get the first line of a band, given a number of lines split in bands of same size
+ *
+ * @param nbLines number of lines
+ * @param nbBands number of bands
+ * @param band the band
+ *
+ * @return the first line of the band
+ */
+inline int getBandBegin( int nbLines, int nbBands, int band )
+{
+    return static_cast< int >( static_cast< long >( nbLines ) * band / nbBands );
+}
+
+/**
+ * Find the min and max values of a line
+ *
+ * @param data line of data
+ * @param width number of pixels of a line
+ * @param min min value (updated)
+ * @param max max value (updated)
+ */
+inline void minMaxRow( const float* data, int width, float& min, float& max )
+{
+    int y = 0;
+#ifdef ALGORITHM_USE_SSE
+    __m128 minimum = _mm_set1_ps( min );
+    __m128 maximum = _mm_set1_ps( max );
+    for ( ; y + 4 <= width; y += 4 ) {
+        const __m128 value = _mm_loadu_ps( data + y );
+        minimum = _mm_min_ps( minimum, value );
+        maximum = _mm_max_ps( maximum, value );
+    }
+
+    // Reduce min and max values
+    float block[ 4 ];
+    _mm_storeu_ps( block, minimum );
+    min = std::min( std::min( block[ 0 ], block[ 1 ] ), std::min( block[ 2 ], block[ 3 ] ) );
+    _mm_storeu_ps( block, maximum );
+    max = std::max( std::max( block[ 0 ], block[ 1 ] ), std::max( block[ 2 ], block[ 3 ] ) );
+#endif
+    for ( ; y < width; y++ ) {
+        min = std::min( min, data[ y ] );
+        max = std::max( max, data[ y ] );
+    }
+}
+
+/**
+ * Parallel min/max reduction : each band of lines is reduced by a worker thread
+ */
+class MinMaxBody : public cv::ParallelLoopBody
+{
+
+public:
+
+    /**
+     * Constructor
+     *
+     * @param src input data
+     * @param nbBands number of bands of lines
+     * @param min min value of each band
+     * @param max max value of each band
+     */
+    MinMaxBody( const cv::Mat& src, int nbBands, float* min, float* max )
+    :   _src( src )
+    ,   _nbBands( nbBands )
+    ,   _min( min )
+    ,   _max( max )
+    {
+    }
+
+    /**
+     * Reduce a range of bands
+     *
+     * @param range range of bands
+     */
+    virtual void operator()( const cv::Range& range ) const
+    {
+        for ( int band = range.start; band < range.end; band++ ) {
+            float min = std::numeric_limits< float >::max();
+            float max = -std::numeric_limits< float >::max();
+            const int end = getBandBegin( _src.rows, _nbBands, band + 1 );
+            for ( int x = getBandBegin( _src.rows, _nbBands, band ); x < end; x++ ) {
+                minMaxRow( _src.ptr< float >( x ), _src.cols, min, max );
+            }
+            _min[ band ] = min;
+            _max[ band ] = max;
+        }
+    }
+
+protected:
+
+    /**
+     * Input data
+     */
+    const cv::Mat& _src;
+
+    /**
+     * Number of bands of lines
+     */
+    int _nbBands;
+
+    /**
+     * Min value of each band
+     */
+    float* _min;
+
+    /**
+     * Max value of each band
+     */
+    float* _max;
+
+};
+
+/**
+ * Parallel local threshold : lines are thresholded by worker threads given a summed area table
+ */
+class LocalThresholdBody : public cv::ParallelLoopBody
+{
+
+public:
+
+    /**
+     * Constructor
+     *
+     * @param src input data
+     * @param integral summed area table of the input data (lines [1,rows-1] and columns [1,cols-1])
+     * @param window size of the window
+     * @param dst output data (copy of the input data)
+     */
+    LocalThresholdBody( const cv::Mat& src, const cv::Mat& integral, int window, cv::Mat& dst )
+    :   _src( src )
+    ,   _integral( integral )
+    ,   _window( window )
+    ,   _dst( dst )
+    {
+    }
+
+    /**
+     * Threshold a range of lines
+     *
+     * @param range range of lines
+     */
+    virtual void operator()( const cv::Range& range ) const
+    {
+        // Mean filter coefficient
+        const float meanFilterCoeff = 1.0f / ( ( _window * 2 + 1 ) * ( _window * 2 + 1 ) );
+
+        for ( int x = range.start; x < range.end; x++ ) {
+            // Window lines, clamped to [1,rows-1]
+            const double* topLine = _integral.ptr< double >( std::max( 1, x - _window ) );
+            const double* bottomLine = _integral.ptr< double >( std::min( _src.rows - 1, x + _window ) + 1 );
+            const float* srcLine = _src.ptr< float >( x );
+            float* dstLine = _dst.ptr< float >( x );
+            for ( int y = 1; y < _src.cols - 1; y++ ) {
+                // Window columns, clamped to [1,cols-1]
+                const int left = std::max( 1, y - _window );
+                const int right = std::min( _src.cols - 1, y + _window ) + 1;
+                const double localSum = bottomLine[ right ] - bottomLine[ left ] - topLine[ right ] + topLine[ left ];
+
+                // Threshold data
+                if ( srcLine[ y ] < static_cast< float >( localSum ) * meanFilterCoeff ) {
+                    dstLine[ y ] = 0.0f;
+                }
+            }
+        }
+    }
+
+protected:
+
+    /**
+     * Input data
+     */
+    const cv::Mat& _src;
+
+    /**
+     * Summed area table of the input data
+     */
+    const cv::Mat& _integral;
+
+    /**
+     * Size of the window
+     */
+    int _window;
+
+    /**
+     * Output data
+     */
+    cv::Mat& _dst;
+
+};
+
+/**
+ * Parallel suppression of isolated points : each neighborhood count is given by 4 lookups in a summed area table
+ */
+class IsolatedPointsBody : public cv::ParallelLoopBody
+{
+
+public:
+
+    /**
+     * Constructor
+     *
+     * @param src input data
+     * @param integral summed area table of the binary mask of the input data (non null data)
+     * @param n size of the ring neighborhood
+     * @param dst output data
+     */
+    IsolatedPointsBody( const cv::Mat& src, const cv::Mat& integral, int n, cv::Mat& dst )
+    :   _src( src )
+    ,   _integral( integral )
+    ,   _n( n )
+    ,   _dst( dst )
+    {
+    }
+
+    /**
+     * Suppress isolated points of a range of lines
+     *
+     * @param range range of lines
+     */
+    virtual void operator()( const cv::Range& range ) const
+    {
+        for ( int x = range.start; x < range.end; x++ ) {
+            const float* srcLine = _src.ptr< float >( x );
+            float* dstLine = _dst.ptr< float >( x );
+
+            // Lines of the border are kept
+            std::copy( srcLine, srcLine + _src.cols, dstLine );
+            if ( x < _n || x >= _src.rows - _n ) {
+                continue;
+            }
+
+            // Window lines
+            const int* topLine = _integral.ptr< int >( x - _n );
+            const int* bottomLine = _integral.ptr< int >( x + _n + 1 );
+            for ( int y = _n; y < _src.cols - _n; y++ ) {
+                // Number of non null data in the neighborhood (pixel included)
+                const int count = bottomLine[ y + _n + 1 ] - bottomLine[ y - _n ] - topLine[ y + _n + 1 ] + topLine[ y - _n ];
+                if ( count <= _n ) {
+                    dstLine[ y ] = 0.0f;
+                }
+            }
+        }
+    }
+
+protected:
+
+    /**
+     * Input data
+     */
+    const cv::Mat& _src;
+
+    /**
+     * Summed area table of the binary mask of the input data
+     */
+    const cv::Mat& _integral;
+
+    /**
+     * Size of the ring neighborhood
+     */
+    int _n;
+
+    /**
+     * Output data
+     */
+    cv::Mat& _dst;
+
+};
+
+/**
+ * Parallel hysteresis (first pass) : each band of lines labels its 8-connected edges (strong or weak) independently
+ * - also used to label the connected components of the parallel edge extraction
+ */
+class HysteresisLabelBody : public cv::ParallelLoopBody
+{
+
+public:
+
+    /**
+     * Constructor
+     *
+     * @param classes classes of pixels (with a border of 1 pixel of no edge)
+     * @param nbBands number of bands of lines
+     * @param labels output labels of pixels local to each band (0 for no edge)
+     * @param nbLabels output number of labels of each band
+     * @param isStrong output flags telling whether or not each label of each band has a strong edge
+     */
+    HysteresisLabelBody( const cv::Mat& classes, int nbBands, cv::Mat& labels, int* nbLabels, std::vector< uchar >* isStrong )
+    :   _classes( classes )
+    ,   _nbBands( nbBands )
+    ,   _labels( labels )
+    ,   _nbLabels( nbLabels )
+    ,   _isStrong( isStrong )
+    {
+    }
+
+    /**
+     * Label a range of bands
+     *
+     * @param range range of bands
+     */
+    virtual void operator()( const cv::Range& range ) const
+    {
+        // Offsets of the 8 neighbors
+        const int stride = static_cast< int >( _classes.step );
+        const int neighbors[ 8 ] = { -stride - 1, -stride, -stride + 1, -1, 1, stride - 1, stride, stride + 1 };
+        const uchar* const classes = _classes.ptr< uchar >( 0 );
+        int* const labels = _labels.ptr< int >( 0 );
+
+        std::vector< int > stack;
+        for ( int band = range.start; band < range.end; band++ ) {
+            // Lines of the band (the border is excluded)
+            // - labels have the same layout as classes
+            const int begin = 1 + getBandBegin( _classes.rows - 2, _nbBands, band );
+            const int end = 1 + getBandBegin( _classes.rows - 2, _nbBands, band + 1 );
+            std::fill( labels + begin * stride, labels + end * stride, 0 );
+            stack.resize( ( end - begin ) * stride );
+
+            int nbLabels = 0;
+            std::vector< uchar >& isStrong = _isStrong[ band ];
+            isStrong.assign( 1, 0 );
+            for ( int x = begin; x < end; x++ ) {
+                for ( int y = 1; y < _classes.cols - 1; y++ ) {
+                    const int seed = x * stride + y;
+                    if ( classes[ seed ] == algorithm::eNoEdge || labels[ seed ] != 0 ) {
+                        continue;
+                    }
+
+                    // Flood fill a new label, restricted to the band
+                    const int label = ++nbLabels;
+                    bool hasStrongEdge = false;
+                    labels[ seed ] = label;
+                    int size = 0;
+                    stack[ size++ ] = seed;
+                    while ( size > 0 ) {
+                        const int pixel = stack[ --size ];
+                        hasStrongEdge = hasStrongEdge || ( classes[ pixel ] == algorithm::eStrongEdge );
+                        for ( int k = 0; k < 8; k++ ) {
+                            const int neighbor = pixel + neighbors[ k ];
+                            if ( neighbor >= begin * stride && neighbor < end * stride &&
+                                 classes[ neighbor ] != algorithm::eNoEdge && labels[ neighbor ] == 0 ) {
+                                labels[ neighbor ] = label;
+                                stack[ size++ ] = neighbor;
+                            }
+                        }
+                    }
+                    isStrong.push_back( hasStrongEdge ? 1 : 0 );
+                }
+            }
+            _nbLabels[ band ] = nbLabels;
+        }
+    }
+
+protected:
+
+    /**
+     * Classes of pixels
+     */
+    const cv::Mat& _classes;
+
+    /**
+     * Number of bands of lines
+     */
+    int _nbBands;
+
+    /**
+     * Labels of pixels local to each band
+     */
+    cv::Mat& _labels;
+
+    /**
+     * Number of labels of each band
+     */
+    int* _nbLabels;
+
+    /**
+     * Flags telling whether or not each label of each band has a strong edge
+     */
+    std::vector< uchar >* _isStrong;
+
+};
+
+/**
+ * Parallel hysteresis (last pass) : edges of labels connected to a strong edge become connected edges
+ */
+class HysteresisRelabelBody : public cv::ParallelLoopBody
+{
+
+public:
+
+    /**
+     * Constructor
+     *
+     * @param classes classes of pixels (with a border of 1 pixel of no edge), modified in place
+     * @param nbBands number of bands of lines
+     * @param labels labels of pixels local to each band
+     * @param firstLabels first global label of each band
+     * @param isConnected flags telling whether or not each global label is connected to a strong edge
+     */
+    HysteresisRelabelBody( cv::Mat& classes, int nbBands, const cv::Mat& labels, const int* firstLabels, const uchar* isConnected )
+    :   _classes( classes )
+    ,   _nbBands( nbBands )
+    ,   _labels( labels )
+    ,   _firstLabels( firstLabels )
+    ,   _isConnected( isConnected )
+    {
+    }
+
+    /**
+     * Relabel a range of bands
+     *
+     * @param range range of bands
+     */
+    virtual void operator()( const cv::Range& range ) const
+    {
+        for ( int band = range.start; band < range.end; band++ ) {
+            const int begin = 1 + getBandBegin( _classes.rows - 2, _nbBands, band );
+            const int end = 1 + getBandBegin( _classes.rows - 2, _nbBands, band + 1 );
+            // Global labels of the band are shifted (local label 0 is no edge)
+            const uchar* isConnected = _isConnected + _firstLabels[ band ];
+            for ( int x = begin; x < end; x++ ) {
+                const int* labelLine = _labels.ptr< int >( x );
+                uchar* classLine = _classes.ptr< uchar >( x );
+                for ( int y = 1; y < _classes.cols - 1; y++ ) {
+                    if ( labelLine[ y ] != 0 && isConnected[ labelLine[ y ] ] ) {
+                        classLine[ y ] = algorithm::eConnectedEdge;
+                    }
+                }
+            }
+        }
+    }
+
+protected:
+
+    /**
+     * Classes of pixels
+     */
+    cv::Mat& _classes;
+
+    /**
+     * Number of bands of lines
+     */
+    int _nbBands;
+
+    /**
+     * Labels of pixels local to each band
+     */
+    const cv::Mat& _labels;
+
+    /**
+     * First global label of each band
+     */
+    const int* _firstLabels;
+
+    /**
+     * Flags telling whether or not each global label is connected to a strong edge
+     */
+    const uchar* _isConnected;
+
+};
+
+/**
+ * Find the root of a label (union-find with path halving)
+ *
+ * @param parents parent of each label
+ * @param label the label
+ *
+ * @return the root of the label
+ */
+inline int findRoot( std::vector< int >& parents, int label )
+{
+    while ( parents[ label ] != label ) {
+        parents[ label ] = parents[ parents[ label ] ];
+        label = parents[ label ];
+    }
+    return label;
+}
+
+/**
+ * Merge labels of bands of lines across band borders (8-connectivity between last line of a band and first line of the next one)
+ *
+ * @param labels labels of pixels local to each band (with a border of 1 pixel of no label)
+ * @param nbBands number of bands of lines
+ * @param firstLabels first global label of each band
+ * @param parents parent of each global label (updated)
+ */
+inline void mergeBandLabels( const cv::Mat& labels, int nbBands, const std::vector< int >& firstLabels, std::vector< int >& parents )
+{
+    const int nbLines = labels.rows - 2;
+    for ( int band = 1; band < nbBands; band++ ) {
+        const int x = 1 + getBandBegin( nbLines, nbBands, band );
+        const int* previousLine = labels.ptr< int >( x - 1 );
+        const int* currentLine = labels.ptr< int >( x );
+        for ( int y = 1; y < labels.cols - 1; y++ ) {
+            if ( currentLine[ y ] == 0 ) {
+                continue;
+            }
+            for ( int dy = -1; dy <= 1; dy++ ) {
+                if ( previousLine[ y + dy ] == 0 ) {
+                    continue;
+                }
+                const int root1 = findRoot( parents, firstLabels[ band - 1 ] + previousLine[ y + dy ] );
+                const int root2 = findRoot( parents, firstLabels[ band ] + currentLine[ y ] );
+                if ( root1 != root2 ) {
+                    parents[ root2 ] = root1;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Parallel polygonal approximation : each chunk of edges is approximated independently
+ */
+class PolygonalApproximationBody : public cv::ParallelLoopBody
+{
+
+public:
+
+    /**
+     * Constructor
+     *
+     * @param listEdges list of edges
+     * @param tolerance max distance between an edge pixel and its segment
+     * @param nbChunks number of chunks of edges
+     * @param polylines output polylines of each chunk
+     */
+    PolygonalApproximationBody( const algorithm::EdgeList& listEdges, float tolerance, int nbChunks, algorithm::Polylines* polylines )
+    :   _listEdges( listEdges )
+    ,   _tolerance( tolerance )
+    ,   _nbChunks( nbChunks )
+    ,   _polylines( polylines )
+    {
+    }
+
+    /**
+     * Approximate a range of chunks
+     *
+     * @param range range of chunks
+     */
+    virtual void operator()( const cv::Range& range ) const
+    {
+        std::vector< int > x;
+        std::vector< int > y;
+        std::vector< int > stack;
+        for ( int chunk = range.start; chunk < range.end; chunk++ ) {
+            algorithm::Polylines& polylines = _polylines[ chunk ];
+            polylines.clear();
+            const int end = getBandBegin( _listEdges.size(), _nbChunks, chunk + 1 );
+            for ( int i = getBandBegin( _listEdges.size(), _nbChunks, chunk ); i < end; i++ ) {
+                algorithm::approximateEdge( _listEdges, _listEdges._edges[ i ], _tolerance, x, y, stack, polylines );
+            }
+        }
+    }
+
+protected:
+
+    /**
+     * List of edges
+     */
+    const algorithm::EdgeList& _listEdges;
+
+    /**
+     * Max distance between an edge pixel and its segment
+     */
+    float _tolerance;
+
+    /**
+     * Number of chunks of edges
+     */
+    int _nbChunks;
+
+    /**
+     * Polylines of each chunk
+     */
+    algorithm::Polylines* _polylines;
+
+};
+
+/**
+ * Check whether or not an edge is closed : its end is next to its start, with at least 3 pixels
+ *
+ * @param edg the edge
+ *
+ * @return a flag telling whether or not the edge is closed
+ */
+inline bool isClosedEdge( const algorithm::Edge& edg )
+{
+    return edg._length >= 2 && std::abs( edg.e_x - edg.s_x ) <= 1 && std::abs( edg.e_y - edg.s_y ) <= 1;
+}
+
+/**
+ * Extend the bounding box of an edge with the pixels of a part of its Freeman code
+ *
+ * @param edg the edge
+ * @param x line of the first pixel
+ * @param y column of the first pixel
+ * @param directions Freeman directions from the first pixel
+ */
+inline void extendBoundingBox( algorithm::Edge& edg, int x, int y, const std::vector< ushort >& directions )
+{
+    //Freeman directions encoding
+    static const int freemanDirections[ 8 ][ 2 ] = { {0,1}, {-1,1}, {-1,0}, {-1,-1}, {0,-1}, {1,-1}, {1,0}, {1,1} };
+
+    for ( size_t k = 0; k <= directions.size(); k++ ) {
+        edg._minX = std::min( edg._minX, x );
+        edg._maxX = std::max( edg._maxX, x );
+        edg._minY = std::min( edg._minY, y );
+        edg._maxY = std::max( edg._maxY, y );
+        if ( k < directions.size() ) {
+            x += freemanDirections[ directions[ k ] ][ 0 ];
+            y += freemanDirections[ directions[ k ] ][ 1 ];
+        }
+    }
+}
+
+/**
+ * Get the Freeman direction of a move to a neighbor
+ *
+ * @param dx move along lines (-1, 0 or 1)
+ * @param dy move along columns (-1, 0 or 1)
+ *
+ * @return the Freeman direction (-1 if there is no move)
+ */
+inline int getFreemanDirection( int dx, int dy )
+{
+    static const int freemanCodes[ 3 ][ 3 ] = { { 3, 2, 1 }, { 4, -1, 0 }, { 5, 6, 7 } };
+    return freemanCodes[ dx + 1 ][ dy + 1 ];
+}
+
+/**
+ * Add the Freeman directions of a digital segment to the last edge of a list (start pixel excluded, end pixel included)
+ *
+ * @param listEdges list of edges
+ * @param x1 line of the start pixel
+ * @param y1 column of the start pixel
+ * @param x2 line of the end pixel
+ * @param y2 column of the end pixel
+ */
+inline void pushSegment( algorithm::EdgeList& listEdges, int x1, int y1, int x2, int y2 )
+{
+    const int nbSteps = std::max( std::abs( x2 - x1 ), std::abs( y2 - y1 ) );
+    int x = x1;
+    int y = y1;
+    for ( int k = 1; k <= nbSteps; k++ ) {
+        const int newX = x1 + static_cast< int >( floor( static_cast< float >( ( x2 - x1 ) * k ) / nbSteps + 0.5f ) );
+        const int newY = y1 + static_cast< int >( floor( static_cast< float >( ( y2 - y1 ) * k ) / nbSteps + 0.5f ) );
+        listEdges.pushDirection( getFreemanDirection( newX - x, newY - y ) );
+        x = newX;
+        y = newY;
+    }
+}
+
+/**
+ * Parallel edge extraction : each chunk of connected components traces its edges (Freeman codes) independently
+ * - components are disjoint and edges never leave their component, so each component only reads and writes
+ *   its own pixels of the shared matrix of pixels already seen
+ */
+class EdgeTracingBody : public cv::ParallelLoopBody
+{
+
+public:
+
+    /**
+     * Constructor
+     *
+     * @param src input matrix
+     * @param dejaVue matrix of pixels already seen (modified in place)
+     * @param seeds start pixels (x * cols + y) of all components, in raster order inside each component
+     * @param firstSeeds index of the first seed of each component (and total number of seeds at the end)
+     * @param nbChunks number of chunks of components
+     * @param listEdges output list of edges of each chunk
+     */
+    EdgeTracingBody( cv::Mat& src, cv::Mat& dejaVue, const std::vector< int >& seeds, const std::vector< int >& firstSeeds, int nbChunks, algorithm::EdgeList* listEdges )
+    :   _src( src )
+    ,   _dejaVue( dejaVue )
+    ,   _seeds( seeds )
+    ,   _firstSeeds( firstSeeds )
+    ,   _nbChunks( nbChunks )
+    ,   _listEdges( listEdges )
+    {
+    }
+
+    /**
+     * Trace edges of a range of chunks
+     *
+     * @param range range of chunks
+     */
+    virtual void operator()( const cv::Range& range ) const
+    {
+        const int nbComponents = static_cast< int >( _firstSeeds.size() ) - 1;
+        for ( int chunk = range.start; chunk < range.end; chunk++ ) {
+            algorithm::EdgeList& listEdges = _listEdges[ chunk ];
+            listEdges.clear();
+            const int begin = _firstSeeds[ getBandBegin( nbComponents, _nbChunks, chunk ) ];
+            const int end = _firstSeeds[ getBandBegin( nbComponents, _nbChunks, chunk + 1 ) ];
+            for ( int i = begin; i < end; i++ ) {
+                const int x = _seeds[ i ] / _src.cols;
+                const int y = _seeds[ i ] % _src.cols;
+                if ( _dejaVue.at< uchar >( x, y ) == 0 ) {
+                    _dejaVue.at< uchar >( x, y ) = 1;
+                    listEdges.startEdge( x, y );
+                    algorithm::freemanEdges( _src, _dejaVue, listEdges );
+                }
+            }
+        }
+    }
+
+protected:
+
+    /**
+     * Input matrix
+     */
+    cv::Mat& _src;
+
+    /**
+     * Matrix of pixels already seen
+     */
+    cv::Mat& _dejaVue;
+
+    /**
+     * Start pixels of all components
+     */
+    const std::vector< int >& _seeds;
+
+    /**
+     * Index of the first seed of each component
+     */
+    const std::vector< int >& _firstSeeds;
+
+    /**
+     * Number of chunks of components
+     */
+    int _nbChunks;
+
+    /**
+     * List of edges of each chunk
+     */
+    algorithm::EdgeList* _listEdges;
+
+};
+
+}
+ 
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Constructor
+ ******************************************************************************/
+algorithm::algorithm()
+{
+}
+
+/******************************************************************************
+ * Image filtering - Convolution
+ * - use a kernel to filter an image (in place)
+ *
+ * @param src input image that will be filtered by a kernel
+ * @param filter kernel (Mean, Prewitt, Sobel, etc...)
+ *
+ * @return output filtered data
+ ******************************************************************************/
+cv::Mat algorithm::filter( const cv::Mat& src, const cv::Mat& filter )
+{
+    // Separable kernels (Prewitt, Sobel, etc...) are applied as two 1D passes
+    float column[ 3 ];
+    float row[ 3 ];
+    if ( isSeparable( filter, column, row ) )
+    {
+        return filterSeparable( src, column, row );
+    }
+
+	// Output
+    cv::Mat res = cv::Mat( src.rows, src.cols, src.type() );
+    res.setTo( 0 );
+
+    // 3x3 kernels are applied line by line by the convolution backend (SIMD if available)
+    if ( filter.rows == 3 && filter.cols == 3 && filter.type() == CV_32F && src.type() == CV_32F )
+    {
+        float kernel[ 9 ];
+        for ( int i = 0; i < 3; i++ ) {
+            for ( int j = 0; j < 3; j++ ) {
+                kernel[ i * 3 + j ] = filter.at< float >( i, j );
+            }
+        }
+
+        // Iterate through image lines
+        for ( int x = 1; x < src.rows - 1; x++ ) {
+            Convolution::filterRow( src.ptr< float >( x - 1 ), src.ptr< float >( x ), src.ptr< float >( x + 1 ), kernel, res.ptr< float >( x ), src.cols );
+        }
+
+        return res;
+    }
+
+	// Iterate through image columns
+    float value = 0.0f;
+    for ( int x = 1; x < src.rows - 1; x++ ) {
+		// Iterate through image lines
+        for ( int y = 1; y < src.cols - 1; y++ ) {
+
+			// Iterate through filter kernel columns
+            value = 0.0;
+            for ( int i = -1; i < filter.rows - 1; i++ ) {
+				// Iterate through filter kernel lines
+                for ( int j = -1; j < filter.cols - 1; j++ ) {
+
+                    value += src.at< float >( x + i, y + j ) * filter.at< float >( i + 1, j + 1 );
+                }
+            }
+			
+			// Write output
+            res.at< float >( x, y ) = value;
+			
+			// Clamp data
+            /*if ( res.at< float >( x, y ) < 0.0f ){
+                res.at< float >( x, y ) = 0.0f;
+            }
+            if ( res.at< float >( x, y ) > 255.0f ){
+                res.at< float >( x, y ) = 255.0f ;
+            }*/
+        }
+    }
+
+    return res;
+}
+
+/******************************************************************************
+ * Gradient computation - Convolution with a set of directional kernels
+ * - each 3x3 neighborhood is read once and all directions are written together
+ * - line operations go through the SIMD backend of Convolution
+ *
+ * @param src input image
+ * @param kernels list of 3x3 directional kernels
+ * @param NbDirection number of directions
+ * @param gradients output list of directional components of the gradient
+ ******************************************************************************/
+void algorithm::gradient( const cv::Mat& src, const cv::Mat* kernels, int NbDirection, cv::Mat* gradients )
+{
+    if ( ! DirectionalKernels::isValid( src, kernels, NbDirection ) )
+    {
+        // Fallback : one convolution per direction
+        for ( int k = 0; k < NbDirection; k++ ) {
+            gradients[ k ] = filter( src, kernels[ k ] );
+        }
+        return;
+    }
+
+    // Output
+    for ( int k = 0; k < NbDirection; k++ ) {
+        gradients[ k ] = cv::Mat( src.rows, src.cols, CV_32F );
+        gradients[ k ].setTo( 0 );
+    }
+
+    DirectionalKernels directionalKernels( kernels, NbDirection, src.cols );
+    float* directions[ 4 ];
+
+	// Iterate through image lines
+    for ( int x = 1; x < src.rows - 1; x++ ) {
+        for ( int k = 0; k < NbDirection; k++ ) {
+            directions[ k ] = gradients[ k ].ptr< float >( x );
+        }
+        directionalKernels.computeRow( src, x, directions );
+    }
+}
+
+/******************************************************************************
+ * Gradient computation - Module and direction in a single pass
+ * - directional components are only kept line by line, unless requested
+ *
+ * @param src input image
+ * @param kernels list of 3x3 directional kernels
+ * @param NbDirection number of directions
+ * @param norm norm used to compute the module
+ * @param module output normalized module
+ * @param direction output direction code (not masked by the module)
+ * @param slope optional output slope (not masked by the module, NULL if not required)
+ * @param gradients optional output list of directional components of the gradient (NULL if not required)
+ * @param nbGradients number of directional components written in gradients, from the first one
+ *        (e.g. 2 when only X and Y components are required, ignored if gradients is NULL)
+ ******************************************************************************/
+void algorithm::gradientModule( const cv::Mat& src, const cv::Mat* kernels, int NbDirection, NormType norm, cv::Mat& module, cv::Mat& direction, cv::Mat* slope, cv::Mat* gradients, int nbGradients )
+{
+    assert( norm == eLInfinity || norm == eL1 || norm == eL2 );
+
+    // Output
+    module = cv::Mat( src.rows, src.cols, CV_32F );
+    direction = cv::Mat( src.rows, src.cols, CV_8U );
+    if ( slope != NULL ) {
+        *slope = cv::Mat( src.rows, src.cols, CV_32F );
+    }
+
+    if ( ! DirectionalKernels::isValid( src, kernels, NbDirection ) )
+    {
+        // Fallback : one pass per stage
+        cv::Mat directionalComponents[ 4 ];
+        gradient( src, kernels, NbDirection, directionalComponents );
+        for ( int k = 0; gradients != NULL && k < nbGradients; k++ ) {
+            gradients[ k ] = directionalComponents[ k ];
+        }
+        switch ( norm )
+        {
+            case eL1:
+                module = moduleL1( directionalComponents, NbDirection );
+                break;
+
+            case eL2:
+                module = moduleL2( directionalComponents, NbDirection );
+                break;
+
+            default:
+                module = moduleLinf( directionalComponents, NbDirection );
+                break;
+        }
+        for ( int x = 0; x < src.rows; x++ ) {
+            const float* gx = directionalComponents[ 0 ].ptr< float >( x );
+            const float* gy = directionalComponents[ 1 ].ptr< float >( x );
+            directionRow( gx, gy, direction.ptr< uchar >( x ), src.cols );
+            if ( slope != NULL ) {
+                slopeRow( gx, gy, slope->ptr< float >( x ), src.cols );
+            }
+        }
+        return;
+    }
+
+    // Directional components : either requested images or a single line of each direction
+    const int nbStoredGradients = ( gradients != NULL ) ? std::min( nbGradients, NbDirection ) : 0;
+    for ( int k = 0; k < nbStoredGradients; k++ ) {
+        gradients[ k ] = cv::Mat( src.rows, src.cols, CV_32F );
+        gradients[ k ].setTo( 0 );
+    }
+    cv::Mat buffer = cv::Mat( NbDirection, src.cols, CV_32F );
+
+    DirectionalKernels directionalKernels( kernels, NbDirection, src.cols );
+    float* directions[ 4 ];
+
+    // Initialize min and max values
+    float min = std::numeric_limits< float >::max();
+    float max = -std::numeric_limits< float >::max();
+
+	// Iterate through image lines
+    for ( int x = 0; x < src.rows; x++ ) {
+
+        // Directional components
+        for ( int k = 0; k < NbDirection; k++ ) {
+            directions[ k ] = ( k < nbStoredGradients ) ? gradients[ k ].ptr< float >( x ) : buffer.ptr< float >( k );
+        }
+        if ( x > 0 && x < src.rows - 1 ) {
+            directionalKernels.computeRow( src, x, directions );
+        } else {
+            // Image border
+            buffer.setTo( 0 );
+        }
+
+        // Module
+        moduleRow( directions, NbDirection, norm, module.ptr< float >( x ), src.cols, min, max );
+
+        // Direction
+        directionRow( directions[ 0 ], directions[ 1 ], direction.ptr< uchar >( x ), src.cols );
+        if ( slope != NULL ) {
+            slopeRow( directions[ 0 ], directions[ 1 ], slope->ptr< float >( x ), src.cols );
+        }
+    }
+
+	// Rescale module between 0 and 255 (min and max values are already known)
+    for ( int x = 0; x < src.rows; x++ ) {
+        rescaleRow( module.ptr< float >( x ), module.ptr< float >( x ), src.cols, min, max );
+    }
+}
+
 /******************************************************************************
- ****************************** NAMESPACE SECTION *****************************
+ * Check whether or not directional kernels can be decomposed
+ *
+ * @param src input image
+ * @param kernels list of directional kernels
+ * @param NbDirection number of directions
+ *
+ * @return a flag telling whether or not kernels can be decomposed
  ******************************************************************************/
+bool algorithm::DirectionalKernels::isValid( const cv::Mat& src, const cv::Mat* kernels, int NbDirection )
+{
+    bool isValid = ( src.type() == CV_32F && src.rows >= 3 && src.cols >= 3 && NbDirection >= 2 && NbDirection <= 4 );
+    for ( int k = 0; isValid && k < NbDirection; k++ ) {
+        isValid = kernels[ k ].rows == 3 && kernels[ k ].cols == 3 && kernels[ k ].type() == CV_32F;
+    }
 
-// STL
-using namespace std;
+    return isValid;
+}
 
 /******************************************************************************
- ************************* DEFINE AND CONSTANT SECTION ************************
+ * Constructor
+ * - each kernel is split in a symmetric and an antisymmetric part
+ *   with respect to its center. Responses are then linear combinations of
+ *   the 4 differences and the 4 sums of opposite neighbors, which are shared
+ *   by all directions (e.g. Prewitt X/Y and diagonal kernels only use differences).
+ *
+ * @param kernels list of 3x3 directional kernels
+ * @param NbDirection number of directions
+ * @param width number of pixels of a line
  ******************************************************************************/
- 
-/**
- * percentage of show pixels
- */
-//float algorithm::percent = 80.0f;
+algorithm::DirectionalKernels::DirectionalKernels( const cv::Mat* kernels, int NbDirection, int width )
+:   _nbDirections( NbDirection )
+,   _data( cNbData - 1, width, CV_32F )
+{
+    _data.setTo( 0 );
+    for ( int d = 0; d < cNbData; d++ ) {
+        _isUsed[ d ] = false;
+    }
 
-/**
- * percentage of the high Threshold
- */
-float algorithm::_highThresholdPercent = 60.0f;
+    // Decompose kernels on shared lines of data
+    // - 0 to 3 : differences of opposite neighbors
+    // - 4 to 7 : sums of opposite neighbors
+    // - 8 : center
+    for ( int k = 0; k < NbDirection; k++ ) {
+        for ( int p = 0; p < 4; p++ ) {
+            const float positive = kernels[ k ].at< float >( cPairs[ p ][ 0 ], cPairs[ p ][ 1 ] );
+            const float negative = kernels[ k ].at< float >( 2 - cPairs[ p ][ 0 ], 2 - cPairs[ p ][ 1 ] );
+            const float antisymmetric = 0.5f * ( positive - negative );
+            const float symmetric = 0.5f * ( positive + negative );
+            if ( antisymmetric != 0.0f ) {
+                _terms[ k ].push_back( p );
+                _coefficients[ k ].push_back( antisymmetric );
+            }
+            if ( symmetric != 0.0f ) {
+                _terms[ k ].push_back( 4 + p );
+                _coefficients[ k ].push_back( symmetric );
+            }
+        }
+        if ( kernels[ k ].at< float >( 1, 1 ) != 0.0f ) {
+            _terms[ k ].push_back( 8 );
+            _coefficients[ k ].push_back( kernels[ k ].at< float >( 1, 1 ) );
+        }
+        for ( size_t t = 0; t < _terms[ k ].size(); t++ ) {
+            _isUsed[ _terms[ k ][ t ] ] = true;
+        }
+    }
+}
 
-/**
- * percentage of the low Threshold
- */
-float algorithm::_lowThresholdPercent = 92.0f;
+/******************************************************************************
+ * Opposite neighbors pairs (i.e. kernel positions (i,j) and (2-i,2-j))
+ ******************************************************************************/
+const int algorithm::DirectionalKernels::cPairs[ 4 ][ 2 ] = { { 0, 0 }, { 0, 1 }, { 0, 2 }, { 1, 2 } };
 
 /******************************************************************************
- ***************************** TYPE DEFINITION ********************************
+ * Compute all directional components of a line (except its border)
+ * - line operations go through the SIMD backend of Convolution
+ *
+ * @param src input image
+ * @param x index of the line (must not be on the border)
+ * @param directions output lines (one per direction)
  ******************************************************************************/
+void algorithm::DirectionalKernels::computeRow( const cv::Mat& src, int x, float** directions )
+{
+    const float* rows[ 3 ] = { src.ptr< float >( x - 1 ), src.ptr< float >( x ), src.ptr< float >( x + 1 ) };
+    const float* lines[ cNbData ];
+    for ( int d = 0; d < cNbData - 1; d++ ) {
+        lines[ d ] = _data.ptr< float >( d );
+    }
+    lines[ 8 ] = rows[ 1 ];
+
+    // Line operations work on the output pixels [1,width-2]
+    const int width = src.cols - 2;
+
+    // Differences and sums of opposite neighbors
+    // - neighbor (i,j) of the pixel y is rows[ i ][ y + j - 1 ], read as ( rows[ i ] + j )[ y - 1 ] so that no pointer is before a line
+    for ( int p = 0; p < 4; p++ ) {
+        const float* positive = rows[ cPairs[ p ][ 0 ] ] + cPairs[ p ][ 1 ];
+        const float* negative = rows[ 2 - cPairs[ p ][ 0 ] ] + 2 - cPairs[ p ][ 1 ];
+        if ( _isUsed[ p ] ) {
+            Convolution::subtractRows( positive, negative, _data.ptr< float >( p ) + 1, width );
+        }
+        if ( _isUsed[ 4 + p ] ) {
+            Convolution::addRows( positive, negative, _data.ptr< float >( 4 + p ) + 1, width );
+        }
+    }
+
+    // Directional components (linear combinations of shared lines)
+    for ( int k = 0; k < _nbDirections; k++ ) {
+        float* dst = directions[ k ] + 1;
+        for ( size_t t = 0; t < _terms[ k ].size(); t++ ) {
+            const float* line = lines[ _terms[ k ][ t ] ] + 1;
+            const float coefficient = _coefficients[ k ][ t ];
+            if ( t == 0 ) {
+                Convolution::scaleRow( line, coefficient, dst, width );
+            } else {
+                Convolution::accumulateRow( line, coefficient, dst, width );
+            }
+        }
+        if ( _terms[ k ].empty() ) {
+            for ( int y = 1; y < src.cols - 1; y++ ) {
+                directions[ k ][ y ] = 0.0f;
+            }
+        }
+    }
+}
 
-#define PI 3.14159265
- 
 /******************************************************************************
- ***************************** METHOD DEFINITION ******************************
+ * Apply a mask to a slope
+ * - i.e. slope is set to 0 where the module is 0
+ *
+ * @param slope slope to mask (in place)
+ * @param module input module
  ******************************************************************************/
+void algorithm::maskSlope( cv::Mat& slope, const cv::Mat& module )
+{
+	// Iterate through lines
+    for ( int x = 0; x < module.rows; x++ ) {
+        const float* moduleRow = module.ptr< float >( x );
+        float* slopeRow = slope.ptr< float >( x );
+		// Iterate through columns
+        for ( int y = 0; y < module.cols; y++ ) {
+            if ( moduleRow[ y ] == 0.0f )
+                slopeRow[ y ] = 0.0f;
+        }
+    }
+}
 
 /******************************************************************************
- * Constructor
+ * Apply a mask to a direction code
+ * - i.e. direction code is set to the one of a null slope where the module is 0
+ *
+ * @param direction direction code to mask (in place)
+ * @param module input module
  ******************************************************************************/
-algorithm::algorithm()
+void algorithm::maskDirection( cv::Mat& direction, const cv::Mat& module )
+{
+	// Iterate through lines
+    for ( int x = 0; x < module.rows; x++ ) {
+        const float* moduleLine = module.ptr< float >( x );
+        uchar* directionLine = direction.ptr< uchar >( x );
+		// Iterate through columns
+        for ( int y = 0; y < module.cols; y++ ) {
+            if ( moduleLine[ y ] == 0.0f )
+                directionLine[ y ] = cNullDirection;
+        }
+    }
+}
+
+/******************************************************************************
+ * Generate the direction code of a line given the first two directional components
+ * - only sign and ratio comparisons of the components are used (no trigonometry)
+ *
+ * @param gx line of horizontal components
+ * @param gy line of vertical components
+ * @param dst output line of direction codes
+ * @param width number of pixels of a line
+ ******************************************************************************/
+void algorithm::directionRow( const float* gx, const float* gy, uchar* dst, int width )
 {
+    for ( int y = 0; y < width; y++ ) {
+        const float a = std::abs( gx[ y ] );
+        const float b = std::abs( gy[ y ] );
+
+        // Sector of 45 degrees of the absolute value of the slope
+        int sector;
+        if ( gx[ y ] >= 0.0f ) {
+            // [0,PI/2] : PI/4 where b == a, PI/2 where gx == 0
+            sector = ( b >= a && b > 0.0f ) + ( gx[ y ] == 0.0f && b > 0.0f );
+        } else {
+            // ]PI/2,PI] : 3PI/4 where b == a, PI where gy == 0
+            sector = 2 + ( b <= a ) + ( b == 0.0f );
+        }
+
+        // Sign of the slope
+        dst[ y ] = static_cast< uchar >( ( gy[ y ] < 0.0f ) ? 3 - sector : 4 + sector );
+    }
 }
 
 /******************************************************************************
- * Image filtering - Convolution
- * - use a kernel to filter an image (in place)
+ * Generate the slope of a line given the first two directional components
+ *
+ * @param gx line of horizontal components
+ * @param gy line of vertical components
+ * @param dst output line of slopes
+ * @param width number of pixels of a line
+ ******************************************************************************/
+void algorithm::slopeRow( const float* gx, const float* gy, float* dst, int width )
+{
+    for ( int y = 0; y < width; y++ ) {
+        dst[ y ] = atan2( gy[ y ], gx[ y ] );
+    }
+}
+
+/******************************************************************************
+ * Non-maximum suppression of a line of the module (pixels [1,width-2])
+ * - the gradient points to the right if gx >= 0, and downwards if gy < 0 (gy is positive upwards)
+ * - the first neighbor is the "side" pixel (left/right if |gx| >= |gy|, above/below otherwise)
+ *   or the "corner" pixel in the direction of the gradient, the second one is opposite
+ * - min(|gx|,|gy|)/max(|gx|,|gy|) is the weight of the corner pixel (interpolation),
+ *   or the corner pixel is selected if the gradient is more than 22.5 degrees away from the axes
+ *
+ * @param gx line of horizontal components of the gradient
+ * @param gy line of vertical components of the gradient
+ * @param above previous line of the module
+ * @param line current line of the module
+ * @param below next line of the module
+ * @param dst output line
+ * @param width number of pixels of a line
+ * @param interpolate flag telling whether or not to interpolate neighbors
+ ******************************************************************************/
+void algorithm::nonMaximumSuppressionRow( const float* gx, const float* gy, const float* above, const float* line, const float* below, float* dst, int width, bool interpolate )
+{
+    // tan( PI / 8 )
+    const float sectorLimit = 0.41421356f;
+
+    int y = 1;
+#ifdef ALGORITHM_USE_SSE
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 limits = _mm_set1_ps( sectorLimit );
+    for ( ; y <= width - 5; y += 4 ) {
+        const __m128 gxValues = _mm_loadu_ps( gx + y );
+        const __m128 gyValues = _mm_loadu_ps( gy + y );
+        const __m128 a = absolute( gxValues );
+        const __m128 b = absolute( gyValues );
+        const __m128 isHorizontal = _mm_cmpge_ps( a, b );
+        const __m128 isRight = _mm_cmpge_ps( gxValues, zero );
+        const __m128 isDown = _mm_cmplt_ps( gyValues, zero );
+
+        // 8-neighborhood
+        const __m128 left = _mm_loadu_ps( line + y - 1 );
+        const __m128 right = _mm_loadu_ps( line + y + 1 );
+        const __m128 top = _mm_loadu_ps( above + y );
+        const __m128 bottom = _mm_loadu_ps( below + y );
+        const __m128 topLeft = _mm_loadu_ps( above + y - 1 );
+        const __m128 topRight = _mm_loadu_ps( above + y + 1 );
+        const __m128 bottomLeft = _mm_loadu_ps( below + y - 1 );
+        const __m128 bottomRight = _mm_loadu_ps( below + y + 1 );
+
+        // Neighbors in the direction of the gradient (1) and opposite (2)
+        const __m128 side1 = select( isHorizontal, select( isRight, right, left ), select( isDown, bottom, top ) );
+        const __m128 side2 = select( isHorizontal, select( isRight, left, right ), select( isDown, top, bottom ) );
+        const __m128 corner1 = select( isDown, select( isRight, bottomRight, bottomLeft ), select( isRight, topRight, topLeft ) );
+        const __m128 corner2 = select( isDown, select( isRight, topLeft, topRight ), select( isRight, bottomLeft, bottomRight ) );
+        const __m128 minComponent = _mm_min_ps( a, b );
+        const __m128 maxComponent = _mm_max_ps( a, b );
+        __m128 neighbor1;
+        __m128 neighbor2;
+        if ( interpolate ) {
+            // Null gradients would give NaN
+            const __m128 weight = _mm_and_ps( _mm_div_ps( minComponent, maxComponent ), _mm_cmpgt_ps( maxComponent, zero ) );
+            neighbor1 = _mm_add_ps( side1, _mm_mul_ps( weight, _mm_sub_ps( corner1, side1 ) ) );
+            neighbor2 = _mm_add_ps( side2, _mm_mul_ps( weight, _mm_sub_ps( corner2, side2 ) ) );
+        } else {
+            const __m128 isDiagonal = _mm_cmpgt_ps( minComponent, _mm_mul_ps( limits, maxComponent ) );
+            neighbor1 = select( isDiagonal, corner1, side1 );
+            neighbor2 = select( isDiagonal, corner2, side2 );
+        }
+
+        // Keep local maxima
+        const __m128 value = _mm_loadu_ps( line + y );
+        const __m128 isMaximum = _mm_and_ps( _mm_cmpge_ps( value, neighbor1 ), _mm_cmpge_ps( value, neighbor2 ) );
+        _mm_storeu_ps( dst + y, _mm_and_ps( isMaximum, value ) );
+    }
+#endif
+    for ( ; y < width - 1; y++ ) {
+        const float a = std::abs( gx[ y ] );
+        const float b = std::abs( gy[ y ] );
+        const bool isHorizontal = ( a >= b );
+        const int step = ( gx[ y ] >= 0.0f ) ? 1 : -1;
+        const float* forwardLine = ( gy[ y ] < 0.0f ) ? below : above;
+        const float* backwardLine = ( gy[ y ] < 0.0f ) ? above : below;
+
+        // Neighbors in the direction of the gradient (1) and opposite (2)
+        const float side1 = isHorizontal ? line[ y + step ] : forwardLine[ y ];
+        const float side2 = isHorizontal ? line[ y - step ] : backwardLine[ y ];
+        const float corner1 = forwardLine[ y + step ];
+        const float corner2 = backwardLine[ y - step ];
+        const float minComponent = std::min( a, b );
+        const float maxComponent = std::max( a, b );
+        float neighbor1;
+        float neighbor2;
+        if ( interpolate ) {
+            const float weight = ( maxComponent > 0.0f ) ? minComponent / maxComponent : 0.0f;
+            neighbor1 = side1 + weight * ( corner1 - side1 );
+            neighbor2 = side2 + weight * ( corner2 - side2 );
+        } else {
+            const bool isDiagonal = ( minComponent > sectorLimit * maxComponent );
+            neighbor1 = isDiagonal ? corner1 : side1;
+            neighbor2 = isDiagonal ? corner2 : side2;
+        }
+
+        // Keep local maxima
+        const float value = line[ y ];
+        dst[ y ] = ( value >= neighbor1 && value >= neighbor2 ) ? value : 0.0f;
+    }
+}
+
+/******************************************************************************
+ * Append the non null data of a line to a list of edge pixels (stream compaction)
+ * - SSE version if available, groups of 4 null data are skipped with a single test
+ *
+ * @param src input line
+ * @param direction line of direction codes (cNullDirection if NULL)
+ * @param x index of the line
+ * @param width number of pixels of a line
+ * @param edgePixels list of edge pixels (updated)
+ ******************************************************************************/
+void algorithm::compactRow( const float* src, const uchar* direction, int x, int width, EdgePixels& edgePixels )
+{
+    int y = 0;
+#ifdef ALGORITHM_USE_SSE
+    const __m128 zero = _mm_setzero_ps();
+    for ( ; y <= width - 4; y += 4 ) {
+        // Bit mask of non null data
+        int mask = _mm_movemask_ps( _mm_cmpneq_ps( _mm_loadu_ps( src + y ), zero ) );
+        for ( int k = y; mask != 0; k++, mask >>= 1 ) {
+            if ( mask & 1 ) {
+                edgePixels.push_back( x, k, src[ k ], ( direction != NULL ) ? direction[ k ] : cNullDirection );
+            }
+        }
+    }
+#endif
+    for ( ; y < width; y++ ) {
+        if ( src[ y ] != 0.0f ) {
+            edgePixels.push_back( x, y, src[ y ], ( direction != NULL ) ? direction[ y ] : cNullDirection );
+        }
+    }
+}
+
+/******************************************************************************
+ * Check whether or not a 3x3 kernel is separable (i.e. of rank 1)
+ * - if so, the kernel is factorised as the product of a column and a row vector
+ *
+ * @param filter kernel
+ * @param column output vertical 1D kernel (3 values)
+ * @param row output horizontal 1D kernel (3 values)
+ *
+ * @return a flag telling whether or not the kernel is separable
+ ******************************************************************************/
+bool algorithm::isSeparable( const cv::Mat& filter, float* column, float* row )
+{
+    if ( filter.rows != 3 || filter.cols != 3 || filter.type() != CV_32F )
+    {
+        return false;
+    }
+
+    // Find the pivot (i.e. the coefficient with the largest absolute value)
+    int pivotRow = 0;
+    int pivotColumn = 0;
+    for ( int i = 0; i < 3; i++ ) {
+        for ( int j = 0; j < 3; j++ ) {
+            if ( std::abs( filter.at< float >( i, j ) ) > std::abs( filter.at< float >( pivotRow, pivotColumn ) ) ) {
+                pivotRow = i;
+                pivotColumn = j;
+            }
+        }
+    }
+    const float pivot = filter.at< float >( pivotRow, pivotColumn );
+    if ( pivot == 0.0f )
+    {
+        return false;
+    }
+
+    // Rank 1 factorisation : K = column * row
+    for ( int i = 0; i < 3; i++ ) {
+        column[ i ] = filter.at< float >( i, pivotColumn );
+        row[ i ] = filter.at< float >( pivotRow, i ) / pivot;
+    }
+
+    // Check that the factorisation reproduces the whole kernel
+    const float epsilon = 1e-6f * std::abs( pivot );
+    for ( int i = 0; i < 3; i++ ) {
+        for ( int j = 0; j < 3; j++ ) {
+            if ( std::abs( column[ i ] * row[ j ] - filter.at< float >( i, j ) ) > epsilon ) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/******************************************************************************
+ * Image filtering - Convolution with a separable 3x3 kernel
+ * - horizontal pass, then vertical pass on a rolling window of 3 lines
  *
  * @param src input image that will be filtered by a kernel
- * @param filter kernel (Mean, Prewitt, Sobel, etc...)
+ * @param column vertical 1D kernel (3 values)
+ * @param row horizontal 1D kernel (3 values)
  *
  * @return output filtered data
  ******************************************************************************/
-cv::Mat algorithm::filter( const cv::Mat& src, const cv::Mat& filter )
+cv::Mat algorithm::filterSeparable( const cv::Mat& src, const float* column, const float* row )
 {
 	// Output
     cv::Mat res = cv::Mat( src.rows, src.cols, src.type() );
     res.setTo( 0 );
+    if ( src.rows < 3 || src.cols < 3 )
+    {
+        return res;
+    }
 
-	// Iterate through image columns
-    float value = 0.0f;
+    // Rolling window of the 3 last horizontally filtered lines
+    cv::Mat horizontal = cv::Mat( 3, src.cols, CV_32F );
+    horizontal.setTo( 0 );
+
+    // Horizontal pass of the two first lines
+    for ( int x = 0; x < 2; x++ ) {
+        Convolution::filterRowHorizontal( src.ptr< float >( x ), row, horizontal.ptr< float >( x ), src.cols );
+    }
+
+	// Iterate through image lines
     for ( int x = 1; x < src.rows - 1; x++ ) {
-		// Iterate through image lines
-        for ( int y = 1; y < src.cols - 1; y++ ) {
 
-			// Iterate through filter kernel columns
-            value = 0.0;
-            for ( int i = -1; i < filter.rows - 1; i++ ) {
-				// Iterate through filter kernel lines
-                for ( int j = -1; j < filter.cols - 1; j++ ) {
+        // Horizontal pass of the next line
+        float* nextRow = horizontal.ptr< float >( ( x + 1 ) % 3 );
+        Convolution::filterRowHorizontal( src.ptr< float >( x + 1 ), row, nextRow, src.cols );
 
-                    value += src.at< float >( x + i, y + j ) * filter.at< float >( i + 1, j + 1 );
-                }
-            }
-			
-			// Write output
-            res.at< float >( x, y ) = value;
-			
-			// Clamp data
-            /*if ( res.at< float >( x, y ) < 0.0f ){
-                res.at< float >( x, y ) = 0.0f;
-            }
-            if ( res.at< float >( x, y ) > 255.0f ){
-                res.at< float >( x, y ) = 255.0f ;
-            }*/
-        }
+        // Vertical pass
+        const float* previousRow = horizontal.ptr< float >( ( x - 1 ) % 3 );
+        const float* currentRow = horizontal.ptr< float >( x % 3 );
+        Convolution::filterRowVertical( previousRow, currentRow, nextRow, column, res.ptr< float >( x ), src.cols );
     }
 
     return res;
@@ -125,29 +1596,15 @@ cv::Mat algorithm::filter( const cv::Mat& src, const cv::Mat& filter )
  ******************************************************************************/
 void algorithm::normalize( cv::Mat& src )
 {
-	// Initialize min and max values
-    float min = std::numeric_limits<float>::max();
-	float max = std::numeric_limits<float>::min();
-
 	// Find min and max values
-	// Iterate through image columns
-    for ( int x = 0; x < src.rows; x++ ) {
-		// Iterate through image lines
-        for ( int y = 0; y < src.cols; y++ ) {
-            if ( src.at< float >( x, y ) > max )
-                max = src.at< float >( x, y );
-            if ( src.at< float >( x, y ) < min )
-                min = src.at< float >( x, y );
-        }
-    }
+    float min;
+    float max;
+    minMax( src, min, max );
 
 	// Rescale data between 0 and 255
-	// Iterate through image columns
+	// Iterate through image lines
     for ( int x = 0; x < src.rows; x++ ) {
-		// Iterate through image lines
-        for ( int y = 0; y < src.cols; y++ ) {
-            src.at< float >( x, y ) = ( src.at< float >( x, y ) - min ) / ( max - min ) * 255.0f;
-        }
+        rescaleRow( src.ptr< float >( x ), src.ptr< float >( x ), src.cols, min, max );
     }
 }
 
@@ -163,34 +1620,49 @@ cv::Mat algorithm::normalizeData( const cv::Mat& src )
     // Ouput matrice
     cv::Mat res = cv::Mat(src.rows, src.cols, src.type() );
 
-    // Initialize min and max values
-    float min = std::numeric_limits<float>::max();
-    float max = std::numeric_limits<float>::min();
-
     // Find min and max values
-    // Iterate through image columns
-    for ( int x = 0; x < src.rows; x++ ) {
-        // Iterate through image lines
-        for ( int y = 0; y < src.cols; y++ ) {
-            if ( src.at< float >( x, y ) > max )
-                max = src.at< float >( x, y );
-            if ( src.at< float >( x, y ) < min )
-                min = src.at< float >( x, y );
-        }
-    }
+    float min;
+    float max;
+    minMax( src, min, max );
 
     // Rescale data between 0 and 255
-    // Iterate through image columns
+    // Iterate through image lines
     for ( int x = 0; x < src.rows; x++ ) {
-        // Iterate through image lines
-        for ( int y = 0; y < src.cols; y++ ) {
-            res.at< float >( x, y ) = ( src.at< float >( x, y ) - min ) / ( max - min ) * 255.0f;
-        }
+        rescaleRow( src.ptr< float >( x ), res.ptr< float >( x ), src.cols, min, max );
     }
 
     return res;
 }
 
+/******************************************************************************
+ * Find the min and max values of a matrice (i.e. an image)
+ * - bands of lines are reduced in parallel, then results are merged
+ *
+ * @param src input matrice
+ * @param min output min value
+ * @param max output max value
+ ******************************************************************************/
+void algorithm::minMax( const cv::Mat& src, float& min, float& max )
+{
+    min = std::numeric_limits< float >::max();
+    max = -std::numeric_limits< float >::max();
+    if ( src.rows == 0 ) {
+        return;
+    }
+
+    // Reduce bands of lines
+    const int nbBands = std::min( src.rows, 4 * std::max( 1, cv::getNumThreads() ) );
+    std::vector< float > bandMin( nbBands );
+    std::vector< float > bandMax( nbBands );
+    cv::parallel_for_( cv::Range( 0, nbBands ), MinMaxBody( src, nbBands, &bandMin[ 0 ], &bandMax[ 0 ] ) );
+
+    // Merge results
+    for ( int band = 0; band < nbBands; band++ ) {
+        min = std::min( min, bandMin[ band ] );
+        max = std::max( max, bandMax[ band ] );
+    }
+}
+
 /******************************************************************************
  * Set every pixels of a matrice to 0.0 or 255.0
  *
@@ -231,37 +1703,27 @@ cv::Mat algorithm::moduleLinf( cv::Mat* modules, int NbDirection )
 {
 	// Ouput matrice
     cv::Mat res = cv::Mat( modules[0].rows, modules[0].cols, modules[0].type() );
-    float max;
 
-	// Iterate through columns
-    for ( int x = 0; x < modules[0].rows; x++ ) {
-		// Iterate through lines
-        for ( int y = 0; y < modules[0].cols; y++ ) {
+    // Initialize min and max values
+    float min = std::numeric_limits< float >::max();
+    float max = -std::numeric_limits< float >::max();
 
-			// For each pixel, find the max of all components (i.e. norm "L infinite")
-            max = std::max( std::abs( modules[0].at< float >( x, y ) ), std::abs( modules[1].at< float >( x, y ) ) );
-			// Handle multidirectional filtering case
-            if ( NbDirection == 4 ){
-                max = std::max( max, std::abs( modules[2].at< float >( x, y ) ) );
-                max = std::max( max, std::abs( modules[3].at< float >( x, y ) ) );
-            }
-			
-			// Clamp data
-            /*if ( max < 0.0f ){
-                max = 0.0f;
-            }
-            if( max > 255.0f ){
-                max = 255.0f;
-            }*/
-			
-			// Write result
-            res.at< float >( x, y ) = max;
+    const float* directions[ 4 ];
+	// Iterate through lines
+    for ( int x = 0; x < modules[0].rows; x++ ) {
+        for ( int k = 0; k < NbDirection; k++ ) {
+            directions[ k ] = modules[ k ].ptr< float >( x );
         }
+
+        // For each pixel, find the max of all components (i.e. norm "L infinite")
+        moduleRow( directions, NbDirection, eLInfinity, res.ptr< float >( x ), modules[0].cols, min, max );
+    }
+
+	// Normalize result (min and max values are already known)
+    for ( int x = 0; x < res.rows; x++ ) {
+        rescaleRow( res.ptr< float >( x ), res.ptr< float >( x ), res.cols, min, max );
     }
 
-	// Normalize result
-    normalize( res );
-	
     return res;
 }
 
@@ -269,67 +1731,237 @@ cv::Mat algorithm::moduleLinf( cv::Mat* modules, int NbDirection )
  * Generate the module with norm "L1" given a set of components
  * - i.e. for each pixel, compute the sum of absolute of components
  *
- * NOTE : for multidirectional filtering, first find the 2 max components, then compute classical L1 norm
+ * NOTE : for multidirectional filtering, first find the 2 max components, then compute classical L1 norm
+ *
+ * @param modules list of module components
+ * @param NbDirection nulber of directions
+ *
+ * @return the module
+ ******************************************************************************/
+cv::Mat algorithm::moduleL1( cv::Mat* modules, int NbDirection )
+{
+	// Ouput matrice
+    cv::Mat res = cv::Mat( modules[0].rows, modules[0].cols, modules[0].type() );
+
+    // Initialize min and max values
+    float min = std::numeric_limits< float >::max();
+    float max = -std::numeric_limits< float >::max();
+
+    const float* directions[ 4 ];
+	// Iterate through lines
+    for ( int x = 0; x < modules[0].rows; x++ ) {
+        for ( int k = 0; k < NbDirection; k++ ) {
+            directions[ k ] = modules[ k ].ptr< float >( x );
+        }
+
+        // For each pixel, find the sum of absolute values of the 2 max components (i.e. norm "L1")
+        moduleRow( directions, NbDirection, eL1, res.ptr< float >( x ), modules[0].cols, min, max );
+    }
+
+	// Normalize result (min and max values are already known)
+    for ( int x = 0; x < res.rows; x++ ) {
+        rescaleRow( res.ptr< float >( x ), res.ptr< float >( x ), res.cols, min, max );
+    }
+
+    return res;
+}
+
+/******************************************************************************
+ * Generate the module with norm "L2" given a set of components
+ * - i.e. for each pixel, compute the square root of the sum of squared components
+ *
+ * NOTE : for multidirectional filtering, first find the 2 max components, then compute classical L2 norm
+ * NOTE : the square root is approximated if _useFastL2Norm is set
  *
  * @param modules list of module components
  * @param NbDirection nulber of directions
  *
  * @return the module
  ******************************************************************************/
-cv::Mat algorithm::moduleL1( cv::Mat* modules, int NbDirection )
+cv::Mat algorithm::moduleL2( cv::Mat* modules, int NbDirection )
 {
 	// Ouput matrice
     cv::Mat res = cv::Mat( modules[0].rows, modules[0].cols, modules[0].type() );
-    
-	float max1;
-	float max2;
-	// Iterate through columns
-	for ( int x = 0; x < modules[0].rows; x++ ) {
-        // Iterate through lines
-		for ( int y = 0; y < modules[0].cols; y++ ) {
-
-			// For each pixel, find the sum of absolute values of components (i.e. norm "L1")
-            if ( std::abs( modules[0].at< float >( x, y ) ) > std::abs( modules[1].at< float >( x , y ) ) ) {
-                max1 = std::abs( modules[0].at< float >( x, y ) );
-                max2 = std::abs( modules[1].at< float >( x, y ) );
-            } else {
-                max2 = std::abs( modules[0].at< float >( x, y ) );
-                max1 = std::abs( modules[1].at< float >( x, y ) );
-            }
 
-			// Handle multidirectional filtering case
-            if ( NbDirection == 4 ) {
-                if ( std::abs( modules[2].at< float >( x , y ) ) > max1 ) {
-                    max2 = max1;
-                    max1 = std::abs( modules[2].at< float >( x, y ) );
-                } else if ( std::abs( modules[2].at< float >( x, y ) ) > max2 ) {
-                    max2 = std::abs( modules[2].at< float >( x , y ) );
-                }
-                if ( std::abs( modules[3].at< float >( x , y ) ) > max1 ) {
-                    max2 = max1;
-                    max1 = std::abs( modules[3].at< float >( x, y ) );
-                } else if( std::abs( modules[3].at< float >( x , y ) ) > max2 ) {
-                    max2 = std::abs( modules[3].at< float >( x , y ) );
+    // Initialize min and max values
+    float min = std::numeric_limits< float >::max();
+    float max = -std::numeric_limits< float >::max();
+
+    const float* directions[ 4 ];
+	// Iterate through lines
+    for ( int x = 0; x < modules[0].rows; x++ ) {
+        for ( int k = 0; k < NbDirection; k++ ) {
+            directions[ k ] = modules[ k ].ptr< float >( x );
+        }
+
+        // L2 norm
+        moduleRow( directions, NbDirection, eL2, res.ptr< float >( x ), modules[0].cols, min, max );
+    }
+
+	// Normalize result (min and max values are already known)
+    for ( int x = 0; x < res.rows; x++ ) {
+        rescaleRow( res.ptr< float >( x ), res.ptr< float >( x ), res.cols, min, max );
+    }
+
+    return res;
+}
+
+/******************************************************************************
+ * Generate the module of a line given a set of components (not normalized)
+ * - max (L-infinity) and 2 max components (L1, L2) are selected with min/max networks (no branch)
+ * - min and max values of the module are updated in the same pass
+ *
+ * @param directions list of lines of module components
+ * @param NbDirection number of directions
+ * @param norm norm used to compute the module
+ * @param dst output line
+ * @param width number of pixels of a line
+ * @param min min value of the module (updated)
+ * @param max max value of the module (updated)
+ ******************************************************************************/
+void algorithm::moduleRow( const float* const* directions, int NbDirection, NormType norm, float* dst, int width, float& min, float& max )
+{
+#ifdef ALGORITHM_USE_SSE
+    __m128 minimum = _mm_set1_ps( min );
+    __m128 maximum = _mm_set1_ps( max );
+    __m128 component[ 4 ];
+    __m128 max1;
+    __m128 max2;
+    __m128 value;
+
+    // Last pixels are processed in a padded block of 4 pixels
+    float block[ 4 ];
+    for ( int y = 0; y < width; y += 4 ) {
+        const int nbPixels = std::min( 4, width - y );
+
+        // Absolute values of components
+        for ( int k = 0; k < NbDirection; k++ ) {
+            if ( nbPixels == 4 ) {
+                component[ k ] = absolute( _mm_loadu_ps( directions[ k ] + y ) );
+            } else {
+                for ( int i = 0; i < 4; i++ ) {
+                    block[ i ] = ( i < nbPixels ) ? directions[ k ][ y + i ] : 0.0f;
                 }
+                component[ k ] = absolute( _mm_loadu_ps( block ) );
             }
+        }
 
-			// L1 nom
-            res.at< float >( x, y ) = max1 + max2;
-            
-			// Clamp data
-			/*if ( res.at< float >( x, y ) < 0.0f ){
-                res.at< float >( x, y ) = 0.0f;
+        // Max and second max components
+        max1 = _mm_max_ps( component[ 0 ], component[ 1 ] );
+        max2 = _mm_min_ps( component[ 0 ], component[ 1 ] );
+        if ( NbDirection == 4 ) {
+            const __m128 max23 = _mm_max_ps( component[ 2 ], component[ 3 ] );
+            const __m128 min23 = _mm_min_ps( component[ 2 ], component[ 3 ] );
+            max2 = _mm_max_ps( _mm_min_ps( max1, max23 ), _mm_max_ps( max2, min23 ) );
+            max1 = _mm_max_ps( max1, max23 );
+        }
+
+        // Norm
+        switch ( norm )
+        {
+            case eL1:
+                value = _mm_add_ps( max1, max2 );
+                break;
+
+            case eL2:
+                value = squareRoot( _mm_add_ps( _mm_mul_ps( max1, max1 ), _mm_mul_ps( max2, max2 ) ), _useFastL2Norm );
+                break;
+
+            default:
+                value = max1;
+                break;
+        }
+
+        // Write result and update min and max values
+        if ( nbPixels == 4 ) {
+            _mm_storeu_ps( dst + y, value );
+            minimum = _mm_min_ps( minimum, value );
+            maximum = _mm_max_ps( maximum, value );
+        } else {
+            _mm_storeu_ps( block, value );
+            for ( int i = 0; i < nbPixels; i++ ) {
+                dst[ y + i ] = block[ i ];
+                min = std::min( min, block[ i ] );
+                max = std::max( max, block[ i ] );
             }
-            if ( res.at< float >( x , y ) > 255.0f ){
-                res.at< float >( x, y ) = 255.0f;
-            }*/
         }
     }
 
-	// Normalize result
-    normalize( res );
-	
-    return res;
+    // Reduce min and max values
+    _mm_storeu_ps( block, minimum );
+    min = std::min( min, std::min( std::min( block[ 0 ], block[ 1 ] ), std::min( block[ 2 ], block[ 3 ] ) ) );
+    _mm_storeu_ps( block, maximum );
+    max = std::max( max, std::max( std::max( block[ 0 ], block[ 1 ] ), std::max( block[ 2 ], block[ 3 ] ) ) );
+#else
+    float max1;
+    float max2;
+    for ( int y = 0; y < width; y++ ) {
+        // Max and second max components
+        const float a0 = std::abs( directions[ 0 ][ y ] );
+        const float a1 = std::abs( directions[ 1 ][ y ] );
+        max1 = std::max( a0, a1 );
+        max2 = std::min( a0, a1 );
+        if ( NbDirection == 4 ) {
+            const float a2 = std::abs( directions[ 2 ][ y ] );
+            const float a3 = std::abs( directions[ 3 ][ y ] );
+            const float max23 = std::max( a2, a3 );
+            const float min23 = std::min( a2, a3 );
+            max2 = std::max( std::min( max1, max23 ), std::max( max2, min23 ) );
+            max1 = std::max( max1, max23 );
+        }
+
+        // Norm
+        switch ( norm )
+        {
+            case eL1:
+                dst[ y ] = max1 + max2;
+                break;
+
+            case eL2:
+                dst[ y ] = std::sqrt( max1 * max1 + max2 * max2 );
+                break;
+
+            default:
+                dst[ y ] = max1;
+                break;
+        }
+
+        // Update min and max values
+        min = std::min( min, dst[ y ] );
+        max = std::max( max, dst[ y ] );
+    }
+#endif
+}
+
+/******************************************************************************
+ * Rescale a line between 0 and 255 given the min and max values of the image
+ * - lines are set to 0 if the image is uniform
+ *
+ * @param src input line
+ * @param dst output line (can be the input line)
+ * @param width number of pixels of a line
+ * @param min min value of the image
+ * @param max max value of the image
+ ******************************************************************************/
+void algorithm::rescaleRow( const float* src, float* dst, int width, float min, float max )
+{
+    if ( ! ( max > min ) ) {
+        std::fill( dst, dst + width, 0.0f );
+        return;
+    }
+
+    int y = 0;
+#ifdef ALGORITHM_USE_SSE
+    const __m128 minimum = _mm_set1_ps( min );
+    const __m128 range = _mm_set1_ps( max - min );
+    const __m128 scale = _mm_set1_ps( 255.0f );
+    for ( ; y + 4 <= width; y += 4 ) {
+        _mm_storeu_ps( dst + y, _mm_mul_ps( _mm_div_ps( _mm_sub_ps( _mm_loadu_ps( src + y ), minimum ), range ), scale ) );
+    }
+#endif
+    for ( ; y < width; y++ ) {
+        dst[ y ] = ( src[ y ] - min ) / ( max - min ) * 255.0f;
+    }
 }
 
 /******************************************************************************
@@ -371,41 +2003,42 @@ cv::Mat algorithm::pente( cv::Mat* pentes, int NbDirection, const cv::Mat& modul
 }
 
 /******************************************************************************
- * Generate the slope given a module
+ * Generate the color image of the slope given a module
+ * - 8 bits color of the direction code (lookup table) scaled by the module
  *
- * @param slope input slope
+ * @param direction input direction code
  * @param module input module
  *
- * @return the matrice color
+ * @return the matrice color (CV_8UC3)
  ******************************************************************************/
-cv::Mat algorithm::colorMat(const cv::Mat& slope, const cv::Mat& module )
+cv::Mat algorithm::colorMat(const cv::Mat& direction, const cv::Mat& module )
 {
+    // Color mask of each direction code (BGR) : one of four colors per quarter of the circle
+    // - [-PI,-PI/2[ : green, [-PI/2,0[ : magenta, [0,PI/2[ : blue, [PI/2,PI] : red
+    static const uchar colors[ cMaxDirection + 1 ][ 3 ] =
+    {
+        { 0, 255, 0 }, { 0, 255, 0 },
+        { 255, 0, 255 }, { 255, 0, 255 },
+        { 255, 0, 0 }, { 255, 0, 0 },
+        { 0, 0, 255 }, { 0, 0, 255 }, { 0, 0, 255 }
+    };
+
     // Ouput matrice
-    cv::Mat matColor = cv::Mat( module.rows, module.cols, CV_32FC3 );
+    cv::Mat matColor = cv::Mat( module.rows, module.cols, CV_8UC3 );
 
     // Iterate through lines
     for (int x = 0; x < module.rows; x++) {
+        const uchar* directionLine = direction.ptr< uchar >( x );
+        const float* moduleLine = module.ptr< float >( x );
+        uchar* colorLine = matColor.ptr< uchar >( x );
         // Iterate through columns
         for (int y = 0; y < module.cols; y++) {
-
-            //put color into matcolor
-            if ( module.at< float >( x , y ) == 0.0 ){
-                matColor.at< cv::Vec3f >(x,y) = cv::Vec3f( 0.0f, 0.0f, 0.0f );
-            }else {
-                // Map gradient direction to one of four colors
-                //std::cout << max << std::endl;
-                if ( slope.at< float >( x, y ) >= -PI && slope.at< float >( x, y ) < -PI / 2.0f ) {
-                    matColor.at< cv::Vec3f >( x, y )[1] = module.at< float >( x, y );
-                } else if( slope.at< float >( x, y ) >= -PI / 2.0f && slope.at< float >( x, y ) < 0.0f ) {
-                    matColor.at< cv::Vec3f >( x, y )[0] = module.at< float >( x, y );
-                    matColor.at< cv::Vec3f >( x, y )[2] = module.at< float >( x, y );
-                } else if ( slope.at< float >( x, y ) >= 0.0f && slope.at< float >( x, y ) < PI / 2.0f ) {
-                    matColor.at< cv::Vec3f >( x, y )[0] = module.at< float >( x, y );
-                } else {
-                    matColor.at< cv::Vec3f >( x, y )[2] = module.at< float >( x, y );
-                }
-
-            }
+            // Map gradient direction to one of four colors (black where the module is 0)
+            const uchar value = static_cast< uchar >( moduleLine[ y ] );
+            const uchar* color = colors[ directionLine[ y ] ];
+            colorLine[ 3 * y ] = color[ 0 ] & value;
+            colorLine[ 3 * y + 1 ] = color[ 1 ] & value;
+            colorLine[ 3 * y + 2 ] = color[ 2 ] & value;
         }
     }
 
@@ -470,6 +2103,8 @@ cv::Mat algorithm::localThreshold( cv::Mat& src, int window )
  * NOTE : based on an histogram of input data
  * - users have to specify a size to the window of locality
  *
+ * - local means are computed with a summed area table (constant cost whatever the window size)
+ *
  * @param src input data
  * @param window size of the window
  *
@@ -480,46 +2115,31 @@ cv::Mat algorithm::localThresholdEnhanced( cv::Mat& src, int window )
     // Copy of input matrix
     cv::Mat matCopy = src.clone();
 
-    //count number of neighbor
-    float localMean;
-
-    // Mean filter coefficient
-    const float meanFilterCoeff = 1.0f / ( ( window * 2 + 1 ) * ( window * 2 + 1 ) );
-
-    // Iterate through image columns
-    for ( int x = 1; x < src.rows - 1; x++ )
+    // Summed area table (double precision) of lines [1,rows-1] and columns [1,cols-1] (same borders as the window)
+    // - integral( x + 1, y + 1 ) is the sum of data in [1,x]x[1,y]
+    cv::Mat integral = cv::Mat( src.rows + 1, src.cols + 1, CV_64F );
+    integral.setTo( 0.0 );
+    // Iterate through image lines
+    for ( int x = 1; x < src.rows; x++ )
     {
-        // Iterate through image lines
-        for ( int y = 1; y < src.cols - 1; y++ )
+        const float* srcLine = src.ptr< float >( x );
+        const double* previousLine = integral.ptr< double >( x );
+        double* integralLine = integral.ptr< double >( x + 1 );
+        double lineSum = 0.0;
+        // Iterate through image columns
+        for ( int y = 1; y < src.cols; y++ )
         {
-            localMean = 0.0;
-
-            // Iterate through filter kernel columns
-            for ( int i = -window; i <= window; i++ )
-            {
-                // Iterate through filter kernel lines
-                for ( int j = -window; j <= window; j++ )
-                {             
-                    if ( ( ( x + i ) >= 1 ) &&
-                         ( ( x + i ) <= ( src.rows - 1 ) ) &&
-                         ( ( y + j ) >= 1 ) &&
-                         ( ( y + j ) <= ( src.cols - 1 ) ) )
-                    {
-                         //sum of all pixels in the locality
-                         localMean += src.at< float >( x + i, y + j );
-                    }
-                }
-            }
-            localMean *= meanFilterCoeff;
-
-            // Threshold data
-            if ( src.at< float >( x, y ) < localMean )
-            {
-                matCopy.at< float >( x, y ) = 0.0f;
-            }
+            lineSum += srcLine[ y ];
+            integralLine[ y + 1 ] = previousLine[ y + 1 ] + lineSum;
         }
     }
 
+    // Threshold data : each local mean is given by 4 lookups in the summed area table
+    if ( src.rows > 2 )
+    {
+        cv::parallel_for_( cv::Range( 1, src.rows - 1 ), LocalThresholdBody( src, integral, window, matCopy ) );
+    }
+
     return matCopy;
 }
 
@@ -532,47 +2152,166 @@ cv::Mat algorithm::localThresholdEnhanced( cv::Mat& src, int window )
  *
  * @return the computed threshold 
  ******************************************************************************/
-int algorithm::globalThreshold( const cv::Mat& src, float percentFilter )
+float algorithm::globalThreshold( const cv::Mat& src, float percentFilter )
 {
-	// Histogram (initialized to 0)
-    int histogram[ 256 ] = { 0 };
-    
-    unsigned long sumValue = 0;
-
 	// Generate histogram
-	// Iterate through lines
-    for ( int x = 0; x < src.rows; x++ ) {
-		// Iterate through columns
-		for (int y = 0; y < src.cols; y++) {
-            // Fill histogram
-			histogram[ (int)src.at< float >( x, y ) ] += 1;
-            // Update
-			sumValue += (int)src.at< float >( x, y );
-        }
-    }
+    Histogram histogram( _histogramNbBins );
+    histogram.compute( src );
+
+    return globalThreshold( histogram, percentFilter );
+}
+
+/******************************************************************************
+ * Determine a threshold given the histogram of an input dataset with a "global" criteria
+ * - users have to specify a percentage of valid pixels
+ *
+ * @param histogram histogram of input data
+ * @param percentFilter percentage of valid pixels
+ *
+ * @return the computed threshold
+ ******************************************************************************/
+float algorithm::globalThreshold( const Histogram& histogram, float percentFilter )
+{
+    const unsigned long sumValue = static_cast< unsigned long >( histogram.getTotalWeightedSum() );
 
     // LOG - DEBUG
     cout << "Histogram" << endl;
     cout << "- sum: " << sumValue << endl;
-//    for ( int i = 0; i < 256; i++ )
-//    {
-//        cout << histogram[ i ] << " ";
-//    }
-//    cout << endl;
 
 	// Find threshold based on a user defined percentage of valid pixels
+    // - i.e. the bin following the first one whose cumulative weighted sum reaches the target
     unsigned long target = (unsigned long)sumValue * ( ( 100.0f - percentFilter ) / 100.0f );
     cout << "- target: " << target << endl;
-    sumValue = 0;
-    int i = 1;
-    while ( sumValue < target && i < 255 ) {
-        sumValue += histogram[ i ] * i;
-        // Update
-		i++;
-    }
 
 	// Return computed threshold
-    return i;
+    return histogram.getBinValue( std::min( histogram.findCumulativeWeightedSum( static_cast< double >( target ) ) + 1, histogram.getNbBins() - 1 ) );
+}
+
+/******************************************************************************
+ * Determine a threshold given an input dataset with the Otsu criteria
+ * - maximize the between-class variance of the two classes of data
+ *
+ * @param src input data
+ *
+ * @return the computed threshold
+ ******************************************************************************/
+float algorithm::otsuThreshold( const cv::Mat& src )
+{
+	// Generate histogram
+    Histogram histogram( _histogramNbBins );
+    histogram.compute( src );
+
+    return otsuThreshold( histogram );
+}
+
+/******************************************************************************
+ * Determine a threshold given the histogram of an input dataset with the Otsu criteria
+ * - O(bins) thanks to the cumulative counts and weighted sums of the histogram
+ *
+ * @param histogram histogram of input data
+ *
+ * @return the computed threshold (data below are rejected)
+ ******************************************************************************/
+float algorithm::otsuThreshold( const Histogram& histogram )
+{
+    const int nbBins = histogram.getNbBins();
+    const double totalCount = static_cast< double >( histogram.getTotalCount() );
+    const double totalSum = histogram.getTotalWeightedSum();
+
+    // Iterate through thresholds : the background class is made of bins [0,bin-1]
+    // - n0.n1.(m0-m1)^2 is proportional to the between-class variance
+    int threshold = 1;
+    double maxVariance = -1.0;
+    for ( int bin = 1; bin < nbBins; bin++ ) {
+        const double n0 = static_cast< double >( histogram.getCumulativeCount( bin - 1 ) );
+        const double n1 = totalCount - n0;
+        if ( n0 == 0.0 || n1 == 0.0 ) {
+            continue;
+        }
+        const double s0 = histogram.getCumulativeWeightedSum( bin - 1 );
+        const double meanDifference = s0 / n0 - ( totalSum - s0 ) / n1;
+        const double variance = n0 * n1 * meanDifference * meanDifference;
+        if ( variance > maxVariance ) {
+            maxVariance = variance;
+            threshold = bin;
+        }
+    }
+
+    // LOG
+    cout << "- Otsu threshold bin: " << threshold << endl;
+
+    return histogram.getBinValue( threshold );
+}
+
+/******************************************************************************
+ * Determine a threshold given an input dataset with the Kapur entropy criteria
+ * - maximize the sum of the entropies of the two classes of data
+ *
+ * @param src input data
+ *
+ * @return the computed threshold
+ ******************************************************************************/
+float algorithm::entropyThreshold( const cv::Mat& src )
+{
+	// Generate histogram
+    Histogram histogram( _histogramNbBins );
+    histogram.compute( src );
+
+    return entropyThreshold( histogram );
+}
+
+/******************************************************************************
+ * Determine a threshold given the histogram of an input dataset with the Kapur entropy criteria
+ * - O(bins) with a single cumulative pass over the bins
+ *
+ * @param histogram histogram of input data
+ *
+ * @return the computed threshold (data below are rejected)
+ ******************************************************************************/
+float algorithm::entropyThreshold( const Histogram& histogram )
+{
+    const int nbBins = histogram.getNbBins();
+    const double totalCount = static_cast< double >( histogram.getTotalCount() );
+    if ( totalCount == 0.0 ) {
+        return histogram.getBinValue( 1 );
+    }
+
+    // Sum of p.log(p) of all bins (p : probability of a bin)
+    double totalEntropySum = 0.0;
+    for ( int bin = 0; bin < nbBins; bin++ ) {
+        const double p = static_cast< double >( histogram.getCount( bin ) ) / totalCount;
+        if ( p > 0.0 ) {
+            totalEntropySum += p * std::log( p );
+        }
+    }
+
+    // Iterate through thresholds : the background class is made of bins [0,bin-1]
+    // - entropy of a class of probability P is log(P) - sum(p.log(p))/P
+    int threshold = 1;
+    double maxEntropy = -std::numeric_limits< double >::max();
+    double entropySum0 = 0.0;
+    for ( int bin = 1; bin < nbBins; bin++ ) {
+        const double p = static_cast< double >( histogram.getCount( bin - 1 ) ) / totalCount;
+        if ( p > 0.0 ) {
+            entropySum0 += p * std::log( p );
+        }
+        const unsigned long n0 = histogram.getCumulativeCount( bin - 1 );
+        if ( n0 == 0 || n0 == histogram.getTotalCount() ) {
+            continue;
+        }
+        const double p0 = static_cast< double >( n0 ) / totalCount;
+        const double p1 = 1.0 - p0;
+        const double entropy = std::log( p0 ) - entropySum0 / p0 + std::log( p1 ) - ( totalEntropySum - entropySum0 ) / p1;
+        if ( entropy > maxEntropy ) {
+            maxEntropy = entropy;
+            threshold = bin;
+        }
+    }
+
+    // LOG
+    cout << "- entropy threshold bin: " << threshold << endl;
+
+    return histogram.getBinValue( threshold );
 }
 
 /******************************************************************************
@@ -581,20 +2320,10 @@ int algorithm::globalThreshold( const cv::Mat& src, float percentFilter )
  * @param input data to threshold
  * @param threshold
  ******************************************************************************/
-void algorithm::applyThreshold( cv::Mat* src, int seuil )
+void algorithm::applyThreshold( cv::Mat* src, float seuil )
 {
-	// Iterate through lines
-    for (int x = 0; x < src->rows; x++) {
-        // Iterate through columns
-		for (int y = 0; y < src->cols; y++) {
-            // Threshold data
-			if ( src->at< float >( x, y ) < seuil ) {
-                src->at< float >( x, y ) = 0.0f;
-				// LOG
-                //std::cout << src.at<float>(x,y) << "  " << res.at<uchar>(x,y) << std::endl;
-            }
-        }
-    }
+    // Threshold data in place
+    applyThreshold( *src, seuil, *src );
 }
 
 /******************************************************************************
@@ -605,87 +2334,282 @@ void algorithm::applyThreshold( cv::Mat* src, int seuil )
  *
  * @return the thresholded data
  ******************************************************************************/
-cv::Mat algorithm::applyThreshold( const cv::Mat& pData, int pThreshold )
+cv::Mat algorithm::applyThreshold( const cv::Mat& pData, float pThreshold )
 {
     // Ouput matrice
-    cv::Mat res = pData.clone();
+    cv::Mat res;
+
+    applyThreshold( pData, pThreshold, res );
+
+    return res;
+}
+
+/******************************************************************************
+ * Apply a threshold on a given input dataset into an output buffer
+ * - no copy : the output may be the input (in place) or a buffer reused between calls
+ *
+ * @param pData input data
+ * @param pThreshold threshold (data below are set to 0)
+ * @param pResult thresholded data (allocated if its size or type does not match)
+ ******************************************************************************/
+void algorithm::applyThreshold( const cv::Mat& pData, float pThreshold, cv::Mat& pResult )
+{
+    assert( pData.type() == CV_32F );
+
+    // Ouput matrice (no-op if already allocated, as pData itself when thresholding in place)
+    pResult.create( pData.rows, pData.cols, CV_32F );
+
+    const float threshold = pThreshold;
+#ifdef ALGORITHM_USE_SSE
+    const __m128 thresholds = _mm_set1_ps( threshold );
+#endif
 
     // Iterate through lines
-    for ( int x = 0; x < pData.rows; x++ )
-    {
+    for ( int x = 0; x < pData.rows; x++ ) {
+        const float* dataLine = pData.ptr< float >( x );
+        float* resLine = pResult.ptr< float >( x );
+        int y = 0;
+#ifdef ALGORITHM_USE_SSE
+        // Compare and blend : keep data where data >= threshold, 0 elsewhere
+        for ( ; y <= pData.cols - 4; y += 4 ) {
+            const __m128 data = _mm_loadu_ps( dataLine + y );
+            _mm_storeu_ps( resLine + y, _mm_and_ps( data, _mm_cmpge_ps( data, thresholds ) ) );
+        }
+#endif
         // Iterate through columns
-        for ( int y = 0; y < pData.cols; y++ )
-        {
-            // Threshold data
-            if ( pData.at< float >( x, y ) < static_cast< float >( pThreshold ) )
-            {
-                res.at< float >( x, y ) = 0.0f;
-            }
+        for ( ; y < pData.cols; y++ ) {
+            resLine[ y ] = ( dataLine[ y ] < threshold ) ? 0.0f : dataLine[ y ];
+        }
+    }
+}
+
+/******************************************************************************
+ *  Hysteresis Threshold filtering : Return a Matrice made with a high filter and a low filter
+ * - pixels above the low threshold are kept if 8-connected to a pixel above the high threshold
+ *
+ * @param src The matrice on wich we apply the Threshold
+ * @param classes buffer of the classes of pixels (owned by the caller, reallocated only if the size changes)
+ * @param stack buffer of the flood fill (owned by the caller, grown only if required)
+ *
+ * @return res The matrice filtered
+ ******************************************************************************/
+cv::Mat algorithm::hysteresis( const cv::Mat& src, float& pHysteresisHighThreshold, float& pHysteresisLowThreshold, cv::Mat& classes, std::vector< int >& stack )
+{
+    // Get the two Threshold (from a single histogram)
+    Histogram histogram( _histogramNbBins );
+    histogram.compute( src );
+    const float highThreshold = globalThreshold( histogram, _highThresholdPercent );
+    const float lowThreshold = globalThreshold( histogram, _lowThresholdPercent );
+    assert( highThreshold > lowThreshold );
+
+    // Write output info
+    pHysteresisHighThreshold = highThreshold;
+    pHysteresisLowThreshold = lowThreshold;
+
+    // LOG
+    cout << "- low threshold value: " << lowThreshold << endl;
+    cout << "- high threshold value: " << highThreshold << endl;
+
+    return applyHysteresis( src, highThreshold, lowThreshold, classes, stack );
+}
+
+/******************************************************************************
+ * Automatic hysteresis threshold filtering
+ * - the high threshold is the Otsu threshold, the low one is a ratio of it (_otsuHysteresisLowRatio)
+ *
+ * @param src The matrice on wich we apply the Threshold
+ * @param pHysteresisHighThreshold computed high threshold
+ * @param pHysteresisLowThreshold computed low threshold
+ * @param classes buffer of the classes of pixels (owned by the caller, reallocated only if the size changes)
+ * @param stack buffer of the flood fill (owned by the caller, grown only if required)
+ *
+ * @return res The matrice filtered
+ ******************************************************************************/
+cv::Mat algorithm::otsuHysteresis( const cv::Mat& src, float& pHysteresisHighThreshold, float& pHysteresisLowThreshold, cv::Mat& classes, std::vector< int >& stack )
+{
+    // Get the two Threshold (from a single histogram)
+    Histogram histogram( _histogramNbBins );
+    histogram.compute( src );
+    const float highThreshold = otsuThreshold( histogram );
+    const float lowThreshold = highThreshold * _otsuHysteresisLowRatio;
+
+    // Write output info
+    pHysteresisHighThreshold = highThreshold;
+    pHysteresisLowThreshold = lowThreshold;
+
+    // LOG
+    cout << "- low threshold value: " << lowThreshold << endl;
+    cout << "- high threshold value: " << highThreshold << endl;
+
+    return applyHysteresis( src, highThreshold, lowThreshold, classes, stack );
+}
+
+/******************************************************************************
+ * Hysteresis threshold filtering with given thresholds
+ *
+ * @param src The matrice on wich we apply the Threshold
+ * @param pHighThreshold high threshold
+ * @param pLowThreshold low threshold
+ * @param classes buffer of the classes of pixels (owned by the caller, reallocated only if the size changes)
+ * @param stack buffer of the flood fill (owned by the caller, grown only if required)
+ *
+ * @return res The matrice filtered
+ ******************************************************************************/
+cv::Mat algorithm::applyHysteresis( const cv::Mat& src, float pHighThreshold, float pLowThreshold, cv::Mat& classes, std::vector< int >& stack )
+{
+    // Ouput matrice
+    cv::Mat res = cv::Mat( src.rows, src.cols, src.type() );
+
+    // Classify pixels : strong, weak or no edge
+    classifyHysteresis( src, pHighThreshold, pLowThreshold, classes );
+
+    // Grow strong edges through connected weak edges
+    if ( _useParallelHysteresis ) {
+        connectHysteresisParallel( classes );
+    } else {
+        connectHysteresis( classes, stack );
+    }
+
+    // Iterate through lines
+    for ( int x = 0; x < src.rows; x++ ) {
+        const uchar* classLine = classes.ptr< uchar >( x + 1 ) + 1;
+        const float* srcLine = src.ptr< float >( x );
+        float* resLine = res.ptr< float >( x );
+        // Iterate through columns
+        for ( int y = 0; y < src.cols; y++ ) {
+            resLine[ y ] = ( classLine[ y ] == eConnectedEdge ) ? srcLine[ y ] : 0.0f;
+        }
+    }
+
+    return res;
+}
+
+/******************************************************************************
+ * Classify pixels for a hysteresis threshold : strong, weak or no edge
+ * - strong edges are above the high threshold, weak edges are above the low threshold (null data are not edges)
+ *
+ * @param src input data
+ * @param highThreshold high threshold
+ * @param lowThreshold low threshold
+ * @param classes output classes (8 bits, with a border of 1 pixel of no edge, reallocated only if its size does not match)
+ ******************************************************************************/
+void algorithm::classifyHysteresis( const cv::Mat& src, float highThreshold, float lowThreshold, cv::Mat& classes )
+{
+    classes.create( src.rows + 2, src.cols + 2, CV_8U );
+    classes.setTo( eNoEdge );
+
+    // Iterate through lines
+    for ( int x = 0; x < src.rows; x++ ) {
+        const float* srcLine = src.ptr< float >( x );
+        uchar* classLine = classes.ptr< uchar >( x + 1 ) + 1;
+        // Iterate through columns
+        for ( int y = 0; y < src.cols; y++ ) {
+            const float value = srcLine[ y ];
+            classLine[ y ] = static_cast< uchar >( ( value != 0.0f ) * ( ( value >= lowThreshold ) + ( value >= highThreshold ) ) );
         }
     }
-
-    return res;
 }
 
 /******************************************************************************
- *  Hysteresis Threshold filtering : Return a Matrice made with a high filter and a low filter
- *
- * @param src The matrice on wich we apply the Threshold
+ * Grow strong edges through 8-connected weak edges (flood fill)
+ * - strong edges and weak edges connected to them become connected edges
+ * - each pixel is pushed at most once on an explicit stack (linear time, no recursion)
  *
- * @return res The matrice filtered
+ * @param classes classes of pixels (8 bits, with a border of 1 pixel of no edge), modified in place
+ * @param stack stack buffer (resized to the number of pixels if required, can be reused between calls)
  ******************************************************************************/
-cv::Mat algorithm::hysteresis( const cv::Mat& src, int& pHysteresisHighThreshold, int& pHysteresisLowThreshold )
+void algorithm::connectHysteresis( cv::Mat& classes, std::vector< int >& stack )
 {
-    // Ouput matrice
-    cv::Mat res = cv::Mat( src.rows, src.cols, src.type() );
-    res.setTo(0.0f);
-
-    // Get the two Threshold
-    int highThreshold = globalThreshold( src, _highThresholdPercent );
-    int lowThreshold = globalThreshold( src, _lowThresholdPercent );
-    assert( highThreshold > lowThreshold );
-
-    // Write output info
-    pHysteresisHighThreshold = highThreshold;
-    pHysteresisLowThreshold = lowThreshold;
+    // Offsets of the 8 neighbors
+    const int stride = static_cast< int >( classes.step );
+    const int neighbors[ 8 ] = { -stride - 1, -stride, -stride + 1, -1, 1, stride - 1, stride, stride + 1 };
 
-    // Apply filter
-    cv::Mat highBinaryMat = src.clone();
-    applyThreshold(&highBinaryMat, highThreshold);
-    cv::Mat lowBinaryMat = src.clone();
-    applyThreshold(&lowBinaryMat, lowThreshold);
-    // LOG
-    cout << "- low threshold value: " << lowThreshold << endl;
-    cout << "- high threshold value: " << highThreshold << endl;
+    if ( stack.size() < classes.total() ) {
+        stack.resize( classes.total() );
+    }
+    int* const stackData = &stack[ 0 ];
+    uchar* const data = classes.ptr< uchar >( 0 );
 
-    // Iterate through columns
-    for ( int x = 0; x < src.rows; x++ ) {
-        // Iterate through lines
-        for ( int y = 0; y < src.cols; y++ ) {
+    // Iterate through lines except border
+    for ( int x = 1; x < classes.rows - 1; x++ ) {
+        // Iterate through columns except border
+        for ( int y = 1; y < classes.cols - 1; y++ ) {
+            const int seed = x * stride + y;
+            if ( data[ seed ] != eStrongEdge ) {
+                continue;
+            }
 
-            // For each pixel, test if highBinaryMat as a value
-            if(highBinaryMat.at< float >( x, y ) != 0.0){
-                res.at< float >( x, y ) = highBinaryMat.at< float >( x, y );
-            //else, test if lowBinaryMat as a connexity to highBinaryMat
-            }else if(lowBinaryMat.at< float >( x, y ) != 0.0){
-                if(highBinaryMat.at< float >( x-1, y ) != 0.0){
-                    res.at< float >( x, y ) = lowBinaryMat.at< float >( x, y );
-                }else if(highBinaryMat.at< float >( x, y-1 ) != 0.0){
-                    res.at< float >( x, y ) = lowBinaryMat.at< float >( x, y );
-                }else if(highBinaryMat.at< float >( x+1, y ) != 0.0){
-                    res.at< float >( x, y ) = lowBinaryMat.at< float >( x, y );
-                }else if(highBinaryMat.at< float >( x, y+1 ) != 0.0){
-                    res.at< float >( x, y ) = lowBinaryMat.at< float >( x, y );
+            // Flood fill from a strong edge
+            data[ seed ] = eConnectedEdge;
+            int size = 0;
+            stackData[ size++ ] = seed;
+            while ( size > 0 ) {
+                const int pixel = stackData[ --size ];
+                for ( int k = 0; k < 8; k++ ) {
+                    const int neighbor = pixel + neighbors[ k ];
+                    if ( data[ neighbor ] == eWeakEdge || data[ neighbor ] == eStrongEdge ) {
+                        data[ neighbor ] = eConnectedEdge;
+                        stackData[ size++ ] = neighbor;
+                    }
                 }
             }
         }
     }
+}
+
+/******************************************************************************
+ * Grow strong edges through 8-connected weak edges, with bands of lines processed in parallel
+ * - each band labels its edges independently, labels are merged across band borders (union-find),
+ *   then edges of labels connected to a strong edge become connected edges
+ * - same result as connectHysteresis()
+ *
+ * @param classes classes of pixels (8 bits, with a border of 1 pixel of no edge), modified in place
+ ******************************************************************************/
+void algorithm::connectHysteresisParallel( cv::Mat& classes )
+{
+    const int nbLines = classes.rows - 2;
+    if ( nbLines <= 0 ) {
+        return;
+    }
+
+    // Label bands of lines
+    const int nbBands = std::min( nbLines, 4 * std::max( 1, cv::getNumThreads() ) );
+    cv::Mat labels = cv::Mat( classes.rows, classes.cols, CV_32S );
+    std::vector< int > nbLabels( nbBands, 0 );
+    std::vector< std::vector< uchar > > isStrong( nbBands );
+    cv::parallel_for_( cv::Range( 0, nbBands ), HysteresisLabelBody( classes, nbBands, labels, &nbLabels[ 0 ], &isStrong[ 0 ] ) );
+
+    // Global labels : local labels of a band are shifted by the number of labels of previous bands
+    std::vector< int > firstLabels( nbBands, 0 );
+    int nbGlobalLabels = 1;
+    for ( int band = 0; band < nbBands; band++ ) {
+        firstLabels[ band ] = nbGlobalLabels - 1;
+        nbGlobalLabels += nbLabels[ band ];
+    }
+    std::vector< int > parents( nbGlobalLabels );
+    std::vector< uchar > isConnected( nbGlobalLabels, 0 );
+    for ( int band = 0; band < nbBands; band++ ) {
+        for ( int label = 1; label <= nbLabels[ band ]; label++ ) {
+            parents[ firstLabels[ band ] + label ] = firstLabels[ band ] + label;
+            isConnected[ firstLabels[ band ] + label ] = isStrong[ band ][ label ];
+        }
+    }
 
-    //destroy other matrice
-    highBinaryMat.~Mat();
-    lowBinaryMat.~Mat();
+    // Merge labels across band borders
+    mergeBandLabels( labels, nbBands, firstLabels, parents );
 
-    return res;
+    // A root is connected if one of its labels is, then flatten : a label is connected if its root is
+    for ( int label = 1; label < nbGlobalLabels; label++ ) {
+        if ( isConnected[ label ] ) {
+            isConnected[ findRoot( parents, label ) ] = 1;
+        }
+    }
+    for ( int label = 1; label < nbGlobalLabels; label++ ) {
+        isConnected[ label ] = isConnected[ findRoot( parents, label ) ];
+    }
+
+    // Relabel bands of lines
+    cv::parallel_for_( cv::Range( 0, nbBands ), HysteresisRelabelBody( classes, nbBands, labels, &firstLabels[ 0 ], &isConnected[ 0 ] ) );
 }
 
 /******************************************************************************
@@ -695,61 +2619,79 @@ cv::Mat algorithm::hysteresis( const cv::Mat& src, int& pHysteresisHighThreshold
  ******************************************************************************/
 void algorithm::supprIsoletedPoints( cv::Mat& src, int n )
 {
+    cv::Mat res;
+    supprIsoletedPoints( src, n, res );
+    src = res;
+}
 
-    //count number of neighbor
-    int count;
-
-    // Iterate through lines except border
-    for (int x = n; x < src.rows-n; x++) {
-        // Iterate through columns except border
-        for ( int y = n; y < src.cols-n; y++ ) {
-            count = 0;
-
-            // Iterate through lines neighborhood
-            for (int i = -n; i <= n; i++) {
-                // Iterate through columns neighborhood
-                for (int j = -n; j <= n; j++) {
-
-                    if(src.at< float >( x+i, y+j ) != 0.0)
-                        count += 1;
-
-                }
-            }
-            if(count <= n)
-                src.at< float >( x, y ) = 0.0;
+/******************************************************************************
+ * Suppression of pixels whitout others in n-ring neighborhood, in a separate output
+ * - a pixel is suppressed if its (2n+1)x(2n+1) neighborhood has at most n non null data (pixel included)
+ * - counts are given by a summed area table of the binary mask, so the cost does not depend on n
+ * - counts are computed on input data only (the result does not depend on the order of the lines)
+ *
+ * @param src input data
+ * @param n size of the ring neighborhood
+ * @param dst output data (allocated if its size or type does not match, must not be the input)
+ ******************************************************************************/
+void algorithm::supprIsoletedPoints( const cv::Mat& src, int n, cv::Mat& dst )
+{
+    assert( src.type() == CV_32F );
+    assert( dst.data == NULL || dst.data != src.data );
+
+    // Summed area table of the binary mask
+    // - integral( x + 1, y + 1 ) is the number of non null data in [0,x]x[0,y]
+    cv::Mat integral = cv::Mat( src.rows + 1, src.cols + 1, CV_32S );
+    integral.setTo( 0 );
+    // Iterate through image lines
+    for ( int x = 0; x < src.rows; x++ ) {
+        const float* srcLine = src.ptr< float >( x );
+        const int* previousLine = integral.ptr< int >( x );
+        int* integralLine = integral.ptr< int >( x + 1 );
+        int lineCount = 0;
+        // Iterate through image columns
+        for ( int y = 0; y < src.cols; y++ ) {
+            lineCount += ( srcLine[ y ] != 0.0f );
+            integralLine[ y + 1 ] = previousLine[ y + 1 ] + lineCount;
         }
     }
+
+    // Suppress isolated points
+    dst.create( src.rows, src.cols, CV_32F );
+    cv::parallel_for_( cv::Range( 0, src.rows ), IsolatedPointsBody( src, integral, std::max( 0, n ), dst ) );
 }
 
 /******************************************************************************
  * extract all the local extremum
  *
- * @param slope matrice of the slope value
+ * @param direction matrice of the direction codes
  * @param module input module
  ******************************************************************************/
-cv::Mat algorithm::localExtremum( const cv::Mat& slope, const cv::Mat& module )
+cv::Mat algorithm::localExtremum( const cv::Mat& direction, const cv::Mat& module )
 {
     // Ouput matrice
     cv::Mat res = module.clone();
 
-    int direction;
+    int sector;
     float point1, point2;
 
     // Iterate through lines except border
-    for (int x = 1; x < slope.rows-1; x++) {
+    for (int x = 1; x < direction.rows-1; x++) {
         // Iterate through columns except border
-        for ( int y = 1; y < slope.cols-1; y++ ) {
-            direction = (int)(std::abs(slope.at< float >( x, y ))/(PI/4));
-            assert(direction<5);
+        for ( int y = 1; y < direction.cols-1; y++ ) {
+            // Sector of 45 degrees of the absolute value of the slope
+            const int code = direction.at< uchar >( x, y );
+            assert( code <= cMaxDirection );
+            sector = ( code >= 4 ) ? code - 4 : 3 - code;
 
             //get the two points in the same direction
-            if(direction == 0 || direction == 4){
+            if(sector == 0 || sector == 4){
                 point1 = module.at< float >( x+1, y );
                 point2 = module.at< float >( x-1, y );
-            }else if(direction == 1){
+            }else if(sector == 1){
                 point1 = module.at< float >( x+1, y+1 );
                 point2 = module.at< float >( x-1, y-1 );
-            }else if(direction == 2){
+            }else if(sector == 2){
                 point1 = module.at< float >( x, y+1 );
                 point2 = module.at< float >( x, y-1 );
             }else{
@@ -769,23 +2711,92 @@ cv::Mat algorithm::localExtremum( const cv::Mat& slope, const cv::Mat& module )
     return res;
 }
 
+/******************************************************************************
+ * Non-maximum suppression of the module along the gradient direction
+ * - the two neighbors across the edge are selected from the gradient components (comparisons only)
+ * - either the nearest neighbors (direction quantized in 4 sectors), or neighbors interpolated
+ *   between the two nearest pixels of the 8-neighborhood along the true gradient direction
+ * - borders are kept
+ *
+ * @param gx horizontal components of the gradient
+ * @param gy vertical components of the gradient
+ * @param module input module
+ * @param dst output module (allocated if its size or type does not match, must not be the input)
+ * @param interpolate flag telling whether or not to interpolate neighbors
+ * @param edgePixels output list of edge pixels of the output module, with their direction codes (optional)
+ ******************************************************************************/
+void algorithm::nonMaximumSuppression( const cv::Mat& gx, const cv::Mat& gy, const cv::Mat& module, cv::Mat& dst, bool interpolate, EdgePixels* edgePixels )
+{
+    assert( module.type() == CV_32F && gx.type() == CV_32F && gy.type() == CV_32F );
+    assert( gx.rows == module.rows && gx.cols == module.cols && gy.rows == module.rows && gy.cols == module.cols );
+    assert( dst.data == NULL || dst.data != module.data );
+
+    // Ouput matrice
+    dst.create( module.rows, module.cols, CV_32F );
+    if ( edgePixels != NULL ) {
+        edgePixels->clear( module.rows, module.cols );
+    }
+
+    // Iterate through lines
+    for ( int x = 0; x < module.rows; x++ ) {
+        const float* moduleLine = module.ptr< float >( x );
+        float* dstLine = dst.ptr< float >( x );
+        if ( x == 0 || x == module.rows - 1 || module.cols < 3 ) {
+            std::copy( moduleLine, moduleLine + module.cols, dstLine );
+        } else {
+            dstLine[ 0 ] = moduleLine[ 0 ];
+            dstLine[ module.cols - 1 ] = moduleLine[ module.cols - 1 ];
+            nonMaximumSuppressionRow( gx.ptr< float >( x ), gy.ptr< float >( x ), module.ptr< float >( x - 1 ), moduleLine, module.ptr< float >( x + 1 ), dstLine, module.cols, interpolate );
+        }
+
+        // Edge pixels of the line (while the line is in cache), then their direction codes
+        if ( edgePixels != NULL ) {
+            const int first = edgePixels->size();
+            compactRow( dstLine, NULL, x, module.cols, *edgePixels );
+            const float* gxLine = gx.ptr< float >( x );
+            const float* gyLine = gy.ptr< float >( x );
+            for ( int i = first; i < edgePixels->size(); i++ ) {
+                const int y = edgePixels->_y[ i ];
+                directionRow( gxLine + y, gyLine + y, &edgePixels->_directions[ i ], 1 );
+            }
+        }
+    }
+}
+
+/******************************************************************************
+ * Extract the sparse list of edge pixels (non null data) of an image
+ *
+ * @param src input data
+ * @param direction direction codes of the input data (cNullDirection for all pixels if NULL)
+ * @param edgePixels output list of edge pixels
+ ******************************************************************************/
+void algorithm::extractEdgePixels( const cv::Mat& src, const cv::Mat* direction, EdgePixels& edgePixels )
+{
+    assert( src.type() == CV_32F );
+
+    edgePixels.clear( src.rows, src.cols );
+
+    // Iterate through lines
+    for ( int x = 0; x < src.rows; x++ ) {
+        compactRow( src.ptr< float >( x ), ( direction != NULL ) ? direction->ptr< uchar >( x ) : NULL, x, src.cols, edgePixels );
+    }
+}
+
 /******************************************************************************
  * Detect all edges in the Matrix
  *
  * @param src input matrix
- *
- * @result list of edges
+ * @param listEdges output list of edges
  ******************************************************************************/
-std::vector<algorithm::Edge> algorithm::freemanEncoding( cv::Mat& src )
+void algorithm::freemanEncoding( cv::Mat& src, EdgeList& listEdges )
 {
     //matrix of pixels already encontered
     cv::Mat dejaVue = cv::Mat( src.rows, src.cols, CV_8U );
     dejaVue.setTo(0);
 
      //list of edges
-    std::vector<algorithm::Edge> listEdges;
+    listEdges.clear();
 
-    Edge edg;
     // Iterate through lines
     for (int x = 1; x < src.rows-1; x++) {
         // Iterate through columns
@@ -793,30 +2804,196 @@ std::vector<algorithm::Edge> algorithm::freemanEncoding( cv::Mat& src )
             //std::cout << x << " " << y << std::endl;
             if(dejaVue.at< uchar >( x, y )==0 && src.at< float >( x, y ) > 20.0/*input data is eiher 0 or 255, so it's just a test*/){
                 dejaVue.at< uchar >( x, y ) = 1;
-                edg = *(new Edge());
-                edg.s_x = x;
-                edg.s_y = y;
-                freemanEdges( src, dejaVue, edg );
-                listEdges.push_back(edg);
+                listEdges.startEdge( x, y );
+                freemanEdges( src, dejaVue, listEdges );
             }
         }
     }
+}
+
+/******************************************************************************
+ * Detect all edges in the Matrix, given its list of edge pixels
+ * - edges are started from edge pixels instead of scanning the whole matrix (same result)
+ * - connected components are traced in parallel if required (see _useParallelEdgeExtraction)
+ *
+ * @param src input matrix
+ * @param edgePixels list of edge pixels of the input matrix
+ * @param listEdges output list of edges
+ ******************************************************************************/
+void algorithm::freemanEncoding( cv::Mat& src, const EdgePixels& edgePixels, EdgeList& listEdges )
+{
+    if ( _useParallelEdgeExtraction ) {
+        freemanEncodingParallel( src, edgePixels, listEdges );
+        return;
+    }
+
+    //matrix of pixels already encontered
+    cv::Mat dejaVue = cv::Mat( src.rows, src.cols, CV_8U );
+    dejaVue.setTo(0);
+
+     //list of edges
+    listEdges.clear();
+
+    // Iterate through edge pixels (raster order, as the scan of the whole matrix)
+    for ( int i = 0; i < edgePixels.size(); i++ ) {
+        const int x = edgePixels._x[ i ];
+        const int y = edgePixels._y[ i ];
+        if ( x < 1 || x >= src.rows - 1 || y < 1 || y >= src.cols - 1 ) {
+            continue;
+        }
+        if(dejaVue.at< uchar >( x, y )==0 && src.at< float >( x, y ) > 20.0/*input data is eiher 0 or 255, so it's just a test*/){
+            dejaVue.at< uchar >( x, y ) = 1;
+            listEdges.startEdge( x, y );
+            freemanEdges( src, dejaVue, listEdges );
+        }
+    }
+}
+
+/******************************************************************************
+ * Detect all edges in the Matrix, with connected components traced in parallel
+ * - 8-connected components of edge pixels are labelled with bands of lines in parallel (union-find across band borders),
+ *   then chunks of components trace their edges in parallel (dynamic scheduling of chunks)
+ * - edges are then ordered by start pixel in raster order : same result as the serial version
+ *
+ * @param src input matrix
+ * @param edgePixels list of edge pixels of the input matrix
+ * @param listEdges output list of edges
+ ******************************************************************************/
+void algorithm::freemanEncodingParallel( cv::Mat& src, const EdgePixels& edgePixels, EdgeList& listEdges )
+{
+    listEdges.clear();
+    const int nbLines = src.rows;
+    if ( nbLines <= 0 ) {
+        return;
+    }
+
+    // Edge pixels (8 bits, with a border of 1 pixel of no edge)
+    cv::Mat classes = cv::Mat( src.rows + 2, src.cols + 2, CV_8U );
+    classes.setTo( eNoEdge );
+    for ( int i = 0; i < edgePixels.size(); i++ ) {
+        if ( edgePixels._modules[ i ] > 20.0f/*input data is eiher 0 or 255, so it's just a test*/ ) {
+            classes.at< uchar >( edgePixels._x[ i ] + 1, edgePixels._y[ i ] + 1 ) = eStrongEdge;
+        }
+    }
+
+    // Label bands of lines
+    const int nbBands = std::min( nbLines, 4 * std::max( 1, cv::getNumThreads() ) );
+    cv::Mat labels = cv::Mat( classes.rows, classes.cols, CV_32S );
+    std::vector< int > nbLabels( nbBands, 0 );
+    std::vector< std::vector< uchar > > isStrong( nbBands );
+    cv::parallel_for_( cv::Range( 0, nbBands ), HysteresisLabelBody( classes, nbBands, labels, &nbLabels[ 0 ], &isStrong[ 0 ] ) );
+
+    // Global labels, merged across band borders
+    std::vector< int > firstLabels( nbBands, 0 );
+    std::vector< int > lineFirstLabels( classes.rows, 0 );
+    int nbGlobalLabels = 1;
+    for ( int band = 0; band < nbBands; band++ ) {
+        firstLabels[ band ] = nbGlobalLabels - 1;
+        nbGlobalLabels += nbLabels[ band ];
+        const int end = 1 + getBandBegin( nbLines, nbBands, band + 1 );
+        for ( int x = 1 + getBandBegin( nbLines, nbBands, band ); x < end; x++ ) {
+            lineFirstLabels[ x ] = firstLabels[ band ];
+        }
+    }
+    std::vector< int > parents( nbGlobalLabels );
+    for ( int label = 0; label < nbGlobalLabels; label++ ) {
+        parents[ label ] = label;
+    }
+    mergeBandLabels( labels, nbBands, firstLabels, parents );
+
+    // Components, in label order
+    std::vector< int > components( nbGlobalLabels, -1 );
+    int nbComponents = 0;
+    for ( int label = 1; label < nbGlobalLabels; label++ ) {
+        const int root = findRoot( parents, label );
+        if ( components[ root ] < 0 ) {
+            components[ root ] = nbComponents++;
+        }
+        components[ label ] = components[ root ];
+    }
+    if ( nbComponents == 0 ) {
+        return;
+    }
+
+    // Seeds of components (counting sort of edge pixels, raster order is kept inside each component)
+    // - as the serial version, edges start inside the border
+    std::vector< int > pixelComponents( edgePixels.size(), -1 );
+    std::vector< int > firstSeeds( nbComponents + 1, 0 );
+    for ( int i = 0; i < edgePixels.size(); i++ ) {
+        const int x = edgePixels._x[ i ];
+        const int y = edgePixels._y[ i ];
+        if ( x < 1 || x >= src.rows - 1 || y < 1 || y >= src.cols - 1 || classes.at< uchar >( x + 1, y + 1 ) == eNoEdge ) {
+            continue;
+        }
+        pixelComponents[ i ] = components[ lineFirstLabels[ x + 1 ] + labels.at< int >( x + 1, y + 1 ) ];
+        firstSeeds[ pixelComponents[ i ] + 1 ]++;
+    }
+    for ( int component = 0; component < nbComponents; component++ ) {
+        firstSeeds[ component + 1 ] += firstSeeds[ component ];
+    }
+    std::vector< int > seeds( firstSeeds[ nbComponents ] );
+    std::vector< int > positions( firstSeeds.begin(), firstSeeds.end() - 1 );
+    for ( int i = 0; i < edgePixels.size(); i++ ) {
+        if ( pixelComponents[ i ] >= 0 ) {
+            seeds[ positions[ pixelComponents[ i ] ]++ ] = edgePixels._x[ i ] * src.cols + edgePixels._y[ i ];
+        }
+    }
+
+    //matrix of pixels already encontered
+    cv::Mat dejaVue = cv::Mat( src.rows, src.cols, CV_8U );
+    dejaVue.setTo(0);
 
-    return listEdges;
+    // Trace chunks of components
+    // - more chunks than threads, so that chunks of long edges are balanced
+    const int nbChunks = std::min( nbComponents, 16 * std::max( 1, cv::getNumThreads() ) );
+    std::vector< EdgeList > chunkEdges( nbChunks );
+    cv::parallel_for_( cv::Range( 0, nbChunks ), EdgeTracingBody( src, dejaVue, seeds, firstSeeds, nbChunks, &chunkEdges[ 0 ] ) );
+
+    // Order edges by start pixel
+    std::vector< std::pair< int, std::pair< int, int > > > order;
+    int nbCodes = 0;
+    for ( int chunk = 0; chunk < nbChunks; chunk++ ) {
+        for ( int i = 0; i < chunkEdges[ chunk ].size(); i++ ) {
+            const Edge& edg = chunkEdges[ chunk ]._edges[ i ];
+            order.push_back( std::make_pair( edg.s_x * src.cols + edg.s_y, std::make_pair( chunk, i ) ) );
+        }
+        nbCodes += chunkEdges[ chunk ]._nbCodes;
+    }
+    std::sort( order.begin(), order.end() );
+
+    // Concatenate edges
+    listEdges._edges.reserve( order.size() );
+    listEdges._codes.reserve( ( 3 * nbCodes ) / 32 + 1 );
+    for ( size_t k = 0; k < order.size(); k++ ) {
+        const EdgeList& chunk = chunkEdges[ order[ k ].second.first ];
+        const Edge& edg = chunk._edges[ order[ k ].second.second ];
+        Edge& newEdg = listEdges.startEdge( edg.s_x, edg.s_y );
+        for ( EdgeList::const_iterator itDir = chunk.begin( edg ); itDir != chunk.end( edg ); ++itDir ) {
+            listEdges.pushDirection( *itDir );
+        }
+        const int offset = newEdg._offset;
+        newEdg = edg;
+        newEdg._offset = offset;
+    }
 }
 
  /******************************************************************************
   * Follow an edge to an end
+  * - statistics of the edge are computed on the way, then the edge is removed
+  *   if it is shorter than _edgeMinLength or its contrast is lower than _edgeMinContrast
   *
   * @param src input matrix
   * @param dejaVue matrix of pixels already seen
-  * @param edg Edge to follow
+  * @param listEdges list of edges, the edge to follow is the last one
   ******************************************************************************/
-void algorithm::freemanEdges(cv::Mat& src, cv::Mat& dejaVue, Edge& edg)
+void algorithm::freemanEdges(cv::Mat& src, cv::Mat& dejaVue, EdgeList& listEdges)
 {
     //Freeman directions encoding
     static const int freemanDirections[ 8 ][ 2 ] = { {0,1}, {-1,1}, {-1,0}, {-1,-1}, {0,-1}, {1,-1}, {1,0}, {1,1} };
 
+    //edge to follow
+    Edge& edg = listEdges._edges.back();
+
     //current position
     int new_x = edg.s_x, new_y = edg.s_y;
     int x = new_x, y = new_y;
@@ -827,16 +3004,26 @@ void algorithm::freemanEdges(cv::Mat& src, cv::Mat& dejaVue, Edge& edg)
     //direction to follow
     int dir = 1;
 
+    //statistics of the edge
+    float sumModules = src.at< float >( x, y );
+    edg._minX = edg._maxX = x;
+    edg._minY = edg._maxY = y;
+
     while(true){
 
         new_x = x + freemanDirections[dir][0];
         new_y = y + freemanDirections[dir][1];
 
         if(dejaVue.at< uchar >( new_x, new_y ) ==0 && src.at< float >( new_x, new_y ) > 20.0/*input data is eiher 0 or 255, so it's just a test*/ ){
-            edg._directions.push_back(dir);
+            listEdges.pushDirection(dir);
             x = new_x;
             y = new_y;
             dejaVue.at< uchar >( x, y ) = 1;
+            sumModules += src.at< float >( x, y );
+            edg._minX = std::min( edg._minX, x );
+            edg._maxX = std::max( edg._maxX, x );
+            edg._minY = std::min( edg._minY, y );
+            edg._maxY = std::max( edg._maxY, y );
             count = 0;
             dir = (dir+2)%8;
         }else{
@@ -855,7 +3042,13 @@ void algorithm::freemanEdges(cv::Mat& src, cv::Mat& dejaVue, Edge& edg)
 
     edg.e_x = x;
     edg.e_y = y;
+    edg._meanModule = sumModules / ( edg._length + 1 );
+    edg._isClosed = isClosedEdge( edg );
 
+    //drop short or low contrast edges (pixels stay seen, so they don't start other edges)
+    if ( edg._length + 1 < _edgeMinLength || edg._meanModule < _edgeMinContrast ) {
+        listEdges.popEdge();
+    }
 }
 
 /******************************************************************************
@@ -863,10 +3056,10 @@ void algorithm::freemanEdges(cv::Mat& src, cv::Mat& dejaVue, Edge& edg)
  *
  * @param listEdges list of all edges already exist
  * @param src binary matrice of edges
- * @param slope matrice of gradient directions
+ * @param direction matrice of gradient direction codes
  * @param nbIterations number of iterations for the algorithm
  ******************************************************************************/
-void algorithm::edgesClosure(std::vector<algorithm::Edge>& listEdges, const cv::Mat& src, const cv::Mat& slope, int nbIterations )
+void algorithm::edgesClosure(EdgeList& listEdges, const cv::Mat& src, const cv::Mat& direction, int nbIterations )
 {
    //Freeman directions encoding
    static const int freemanDirections[ 8 ][ 2 ] = { {0,1}, {-1,1}, {-1,0}, {-1,-1}, {0,-1}, {1,-1}, {1,0}, {1,1} };
@@ -887,11 +3080,21 @@ void algorithm::edgesClosure(std::vector<algorithm::Edge>& listEdges, const cv::
    std::vector< ushort > e_vecDir1;
    std::vector< ushort > e_vecDir2;
 
+   //new directions added before and after the Freeman code of the current edge
+   std::vector< ushort > prefix;
+   std::vector< ushort > suffix;
+
    std::vector< ushort >::iterator itDir;
-   std::vector<algorithm::Edge>::iterator itEdg;
+
+   //closed edges, written in a new arena (codes of an edge can't grow in place)
+   EdgeList closedEdges;
+   closedEdges._edges.reserve( listEdges._edges.size() );
+   closedEdges._codes.reserve( listEdges._codes.size() );
 
    //Iterate for all edge already detected
-   for(itEdg = listEdges.begin(); itEdg!=listEdges.end(); ++itEdg){
+   for(int k = 0; k < listEdges.size(); k++){
+       const Edge* itEdg = &listEdges._edges[ k ];
+       Edge closedEdge = *itEdg;
 
        //initiate coord
        s_x1 = itEdg->s_x; s_y1 = itEdg->s_y;
@@ -903,17 +3106,15 @@ void algorithm::edgesClosure(std::vector<algorithm::Edge>& listEdges, const cv::
 
        //don't need to go both way for edge with only 1 point
        if(s_x1==e_x1 && s_y1==e_y1){
-           //s_finish1=true;
-           //s_finish2=true;
-           continue;
+           s_finish1=true; s_finish2=true; e_finish1=true; e_finish2=true;
        }
 
-       //Iterate for nbIterations
-       for(int i=0; i<nbIterations; i++){
+       //Iterate for nbIterations (or until all walks are finished)
+       for(int i=0; i<nbIterations && !(s_finish1 && s_finish2 && e_finish1 && e_finish2); i++){
 
            if(!s_finish1){
                //move to next direction
-               s_dir1 = (int)(((slope.at< float >( s_x1, s_y1 )+PI)/(2*PI))*8.0);
+               s_dir1 = direction.at< uchar >( s_x1, s_y1 );
                s_dir1 = (s_dir1+3)%8;
 
                //get position
@@ -931,13 +3132,12 @@ void algorithm::edgesClosure(std::vector<algorithm::Edge>& listEdges, const cv::
                if(src.at< float >( s_x1, s_y1 )>0.0||src.at< float >( s_x1+ freemanDirections[(s_dir1+1)%8][0], s_y1+ freemanDirections[(s_dir1+1)%8][1] )>0.0||src.at< float >( s_x1+ freemanDirections[(s_dir1+7)%8][0], s_y1+ freemanDirections[(s_dir1+7)%8][1] )>0.0){
 
                    //add the news directions
-                   itDir = itEdg->_directions.begin();
-                   itEdg->_directions.insert(itDir, s_vecDir1.begin(), s_vecDir1.end());
+                   prefix.insert(prefix.begin(), s_vecDir1.begin(), s_vecDir1.end());
                    s_finish1 = true;
 
                    //change start position
-                   itEdg->s_x = s_x1 + freemanDirections[(s_dir1+4)%8][0];
-                   itEdg->s_y = s_y1 + freemanDirections[(s_dir1+4)%8][1];
+                   closedEdge.s_x = s_x1 + freemanDirections[(s_dir1+4)%8][0];
+                   closedEdge.s_y = s_y1 + freemanDirections[(s_dir1+4)%8][1];
                }else{
                    //add the new direction to the temporary vector
                    s_vecDir1.push_back((s_dir1+4)%8);
@@ -946,7 +3146,7 @@ void algorithm::edgesClosure(std::vector<algorithm::Edge>& listEdges, const cv::
 
            if(!s_finish2){
                //move to next direction
-               s_dir2 = (int)(((slope.at< float >( s_x2, s_y2 )+PI)/(2*PI))*8.0);
+               s_dir2 = direction.at< uchar >( s_x2, s_y2 );
                s_dir2 = (s_dir2+7)%8;
 
                //get position
@@ -964,13 +3164,12 @@ void algorithm::edgesClosure(std::vector<algorithm::Edge>& listEdges, const cv::
                if(src.at< float >( s_x2, s_y2 )>0.0||src.at< float >( s_x2+ freemanDirections[(s_dir2+1)%8][0], s_y2+ freemanDirections[(s_dir2+1)%8][1] )>0.0||src.at< float >( s_x2+ freemanDirections[(s_dir2+7)%8][0], s_y2+ freemanDirections[(s_dir2+7)%8][1] )>0.0){
 
                    //add the news directions
-                   itDir = itEdg->_directions.begin();
-                   itEdg->_directions.insert(itDir, s_vecDir2.begin(), s_vecDir2.end());
+                   prefix.insert(prefix.begin(), s_vecDir2.begin(), s_vecDir2.end());
                    s_finish2 = true;
 
                    //change start position
-                   itEdg->s_x = s_x2 + freemanDirections[(s_dir2+4)%8][0];
-                   itEdg->s_y = s_y2 + freemanDirections[(s_dir2+4)%8][1];
+                   closedEdge.s_x = s_x2 + freemanDirections[(s_dir2+4)%8][0];
+                   closedEdge.s_y = s_y2 + freemanDirections[(s_dir2+4)%8][1];
                }else{
                    //add the new direction to the temporary vector
                    s_vecDir2.push_back((s_dir2+4)%8);
@@ -979,7 +3178,7 @@ void algorithm::edgesClosure(std::vector<algorithm::Edge>& listEdges, const cv::
 
            if(!e_finish1){
                //move to next direction
-               e_dir1 = (int)(((slope.at< float >( e_x1, e_y1 )+PI)/(2*PI))*8.0);
+               e_dir1 = direction.at< uchar >( e_x1, e_y1 );
                e_dir1 = (e_dir1+3)%8;
 
                //get position
@@ -996,15 +3195,13 @@ void algorithm::edgesClosure(std::vector<algorithm::Edge>& listEdges, const cv::
                //test if encounter an other edge
                if(src.at< float >( e_x1, e_y1 )>0.0||src.at< float >( e_x1+ freemanDirections[(e_dir1+1)%8][0], e_y1+ freemanDirections[(e_dir1+1)%8][1] )>0.0||src.at< float >( e_x1+ freemanDirections[(e_dir1+7)%8][0], e_y1+ freemanDirections[(e_dir1+7)%8][1] )>0.0){
 
-                   for(itDir = e_vecDir1.begin(); itDir!=e_vecDir1.end(); ++itDir){
-                       //add the news directions
-                       itEdg->_directions.push_back(*itDir);
-                   }
+                   //add the news directions
+                   suffix.insert(suffix.end(), e_vecDir1.begin(), e_vecDir1.end());
                    e_finish1 = true;
 
                    //change end position
-                   itEdg->e_x = e_x1 + freemanDirections[(e_dir1+4)%8][0];;
-                   itEdg->e_y = e_y1 + freemanDirections[(e_dir1+4)%8][1];;
+                   closedEdge.e_x = e_x1 + freemanDirections[(e_dir1+4)%8][0];;
+                   closedEdge.e_y = e_y1 + freemanDirections[(e_dir1+4)%8][1];;
                }else{
                    //add the new direction to the temporary vector
                    e_vecDir1.push_back(e_dir1);
@@ -1013,7 +3210,7 @@ void algorithm::edgesClosure(std::vector<algorithm::Edge>& listEdges, const cv::
 
            if(!e_finish2){
                //move to next direction
-               e_dir2 = (int)(((slope.at< float >( e_x2, e_y2 )+PI)/(2*PI))*8.0);
+               e_dir2 = direction.at< uchar >( e_x2, e_y2 );
                e_dir2 = (e_dir2+7)%8;
 
                //get position
@@ -1030,15 +3227,13 @@ void algorithm::edgesClosure(std::vector<algorithm::Edge>& listEdges, const cv::
                //test if encounter an other edge
                if(src.at< float >( e_x2, e_y2 )>0.0||src.at< float >( e_x2+ freemanDirections[(e_dir2+1)%8][0], e_y2+ freemanDirections[(e_dir2+1)%8][1] )>0.0||src.at< float >( e_x2+ freemanDirections[(e_dir2+7)%8][0], e_y2+ freemanDirections[(e_dir2+7)%8][1] )>0.0){
 
-                   for(itDir = e_vecDir2.begin(); itDir!=e_vecDir2.end(); ++itDir){
-                       //add the news directions
-                       itEdg->_directions.push_back(*itDir);
-                   }
+                   //add the news directions
+                   suffix.insert(suffix.end(), e_vecDir2.begin(), e_vecDir2.end());
                    e_finish2 = true;
 
                    //change end position
-                   itEdg->e_x = e_x2 + freemanDirections[(e_dir2+4)%8][0];
-                   itEdg->e_y = e_y2 + freemanDirections[(e_dir2+4)%8][1];
+                   closedEdge.e_x = e_x2 + freemanDirections[(e_dir2+4)%8][0];
+                   closedEdge.e_y = e_y2 + freemanDirections[(e_dir2+4)%8][1];
                }else{
                    //add the new direction to the temporary vector
                    e_vecDir2.push_back(e_dir2);
@@ -1047,12 +3242,352 @@ void algorithm::edgesClosure(std::vector<algorithm::Edge>& listEdges, const cv::
 
        }
 
+       //write the closed edge : new directions before, Freeman code of the edge, new directions after
+       Edge& edg = closedEdges.startEdge( closedEdge.s_x, closedEdge.s_y );
+       for(itDir = prefix.begin(); itDir!=prefix.end(); ++itDir){
+           closedEdges.pushDirection(*itDir);
+       }
+       for(EdgeList::const_iterator itCode = listEdges.begin( *itEdg ); itCode != listEdges.end( *itEdg ); ++itCode){
+           closedEdges.pushDirection(*itCode);
+       }
+       for(itDir = suffix.begin(); itDir!=suffix.end(); ++itDir){
+           closedEdges.pushDirection(*itDir);
+       }
+
+       //statistics of the edge, new pixels extend its bounding box
+       const int offset = edg._offset;
+       const int length = edg._length;
+       edg = closedEdge;
+       edg._offset = offset;
+       edg._length = length;
+       extendBoundingBox( edg, edg.s_x, edg.s_y, prefix );
+       extendBoundingBox( edg, itEdg->e_x, itEdg->e_y, suffix );
+       edg._isClosed = isClosedEdge( edg );
+
        //empty all the temporary vector of direction
        s_vecDir1.clear();
        s_vecDir2.clear();
        e_vecDir1.clear();
        e_vecDir2.clear();
+       prefix.clear();
+       suffix.clear();
    }
+
+   listEdges.swap( closedEdges );
+}
+
+/******************************************************************************
+ * Connect edges by linking their ends
+ * - ends of open edges are indexed in a grid of cells of the max gap size, so only close ends are compared
+ * - a pair of ends costs its gap (relative to the max gap) plus the deviation of the gap from the tangent at each end,
+ *   pairs are linked by increasing cost while both ends are free (an edge may be closed on itself)
+ * - linked edges are written once, in path order, in a new arena (no Freeman code is ever prepended)
+ *
+ * @param listEdges list of all edges already exist
+ * @param height number of lines of the image
+ * @param width number of columns of the image
+ * @param maxDistance max gap between linked ends (in pixels)
+ ******************************************************************************/
+void algorithm::edgesClosureByEndpoints( EdgeList& listEdges, int height, int width, int maxDistance )
+{
+    //Freeman directions encoding
+    static const int freemanDirections[ 8 ][ 2 ] = { {0,1}, {-1,1}, {-1,0}, {-1,-1}, {0,-1}, {1,-1}, {1,0}, {1,1} };
+
+    const int nbEdges = listEdges.size();
+    if ( nbEdges == 0 || maxDistance <= 0 ) {
+        return;
+    }
+
+    // Ends of edges : end 2i is the start of edge i, end 2i+1 is its end
+    // - tangents point outward
+    const int nbEnds = 2 * nbEdges;
+    std::vector< int > endX( nbEnds );
+    std::vector< int > endY( nbEnds );
+    std::vector< float > tangentX( nbEnds, 0.0f );
+    std::vector< float > tangentY( nbEnds, 0.0f );
+    std::vector< uchar > isOpen( nbEnds, 0 );
+    for ( int i = 0; i < nbEdges; i++ ) {
+        const Edge& edg = listEdges._edges[ i ];
+        endX[ 2 * i ] = edg.s_x;
+        endY[ 2 * i ] = edg.s_y;
+        endX[ 2 * i + 1 ] = edg.e_x;
+        endY[ 2 * i + 1 ] = edg.e_y;
+
+        // Single pixels and closed edges (end next to the start) are not linked
+        if ( edg._length == 0 || std::max( std::abs( edg.e_x - edg.s_x ), std::abs( edg.e_y - edg.s_y ) ) <= 1 ) {
+            continue;
+        }
+        isOpen[ 2 * i ] = isOpen[ 2 * i + 1 ] = 1;
+
+        // Tangents : sum of the first (reversed) and last directions
+        const int nbDirections = std::min( edg._length, static_cast< int >( cTangentLength ) );
+        for ( int k = 0; k < nbDirections; k++ ) {
+            const int first = EdgeList::readCode( listEdges._codes, edg._offset + k );
+            const int last = EdgeList::readCode( listEdges._codes, edg._offset + edg._length - 1 - k );
+            tangentX[ 2 * i ] -= static_cast< float >( freemanDirections[ first ][ 0 ] );
+            tangentY[ 2 * i ] -= static_cast< float >( freemanDirections[ first ][ 1 ] );
+            tangentX[ 2 * i + 1 ] += static_cast< float >( freemanDirections[ last ][ 0 ] );
+            tangentY[ 2 * i + 1 ] += static_cast< float >( freemanDirections[ last ][ 1 ] );
+        }
+        for ( int end = 2 * i; end <= 2 * i + 1; end++ ) {
+            const float norm = sqrt( tangentX[ end ] * tangentX[ end ] + tangentY[ end ] * tangentY[ end ] );
+            if ( norm > 0.0f ) {
+                tangentX[ end ] /= norm;
+                tangentY[ end ] /= norm;
+            }
+        }
+    }
+
+    // Grid of open ends (counting sort by cell)
+    const int nbCellRows = height / maxDistance + 1;
+    const int nbCellColumns = width / maxDistance + 1;
+    std::vector< int > firstEnds( nbCellRows * nbCellColumns + 1, 0 );
+    for ( int end = 0; end < nbEnds; end++ ) {
+        if ( isOpen[ end ] ) {
+            firstEnds[ ( endX[ end ] / maxDistance ) * nbCellColumns + endY[ end ] / maxDistance + 1 ]++;
+        }
+    }
+    for ( int cell = 0; cell < nbCellRows * nbCellColumns; cell++ ) {
+        firstEnds[ cell + 1 ] += firstEnds[ cell ];
+    }
+    std::vector< int > cellEnds( firstEnds.back() );
+    std::vector< int > positions( firstEnds.begin(), firstEnds.end() - 1 );
+    for ( int end = 0; end < nbEnds; end++ ) {
+        if ( isOpen[ end ] ) {
+            cellEnds[ positions[ ( endX[ end ] / maxDistance ) * nbCellColumns + endY[ end ] / maxDistance ]++ ] = end;
+        }
+    }
+
+    // Candidate pairs of ends : ends of the 3x3 neighbor cells, within the max gap and the max angle
+    const float minCosine = static_cast< float >( cos( _edgeClosureMaxAngle * PI / 180.0 ) );
+    std::vector< std::pair< float, std::pair< int, int > > > pairs;
+    for ( int end1 = 0; end1 < nbEnds; end1++ ) {
+        if ( !isOpen[ end1 ] ) {
+            continue;
+        }
+        const int cellX = endX[ end1 ] / maxDistance;
+        const int cellY = endY[ end1 ] / maxDistance;
+        for ( int cx = std::max( 0, cellX - 1 ); cx <= std::min( nbCellRows - 1, cellX + 1 ); cx++ ) {
+            for ( int cy = std::max( 0, cellY - 1 ); cy <= std::min( nbCellColumns - 1, cellY + 1 ); cy++ ) {
+                const int cell = cx * nbCellColumns + cy;
+                for ( int k = firstEnds[ cell ]; k < firstEnds[ cell + 1 ]; k++ ) {
+                    const int end2 = cellEnds[ k ];
+                    // - an edge is closed on itself only if it is long enough to turn back
+                    if ( end2 <= end1 || ( end2 == ( end1 ^ 1 ) && listEdges._edges[ end1 / 2 ]._length < 2 * cTangentLength ) ) {
+                        continue;
+                    }
+                    const int dx = endX[ end2 ] - endX[ end1 ];
+                    const int dy = endY[ end2 ] - endY[ end1 ];
+                    if ( dx * dx + dy * dy > maxDistance * maxDistance ) {
+                        continue;
+                    }
+                    float cost = 0.0f;
+                    if ( dx != 0 || dy != 0 ) {
+                        const float distance = sqrt( static_cast< float >( dx * dx + dy * dy ) );
+                        const float cosine1 = ( tangentX[ end1 ] * dx + tangentY[ end1 ] * dy ) / distance;
+                        const float cosine2 = -( tangentX[ end2 ] * dx + tangentY[ end2 ] * dy ) / distance;
+                        if ( cosine1 < minCosine || cosine2 < minCosine ) {
+                            continue;
+                        }
+                        cost = distance / maxDistance + ( 1.0f - cosine1 ) + ( 1.0f - cosine2 );
+                    }
+                    pairs.push_back( std::make_pair( cost, std::make_pair( end1, end2 ) ) );
+                }
+            }
+        }
+    }
+
+    // Link pairs by increasing cost
+    std::sort( pairs.begin(), pairs.end() );
+    std::vector< int > links( nbEnds, -1 );
+    for ( size_t k = 0; k < pairs.size(); k++ ) {
+        const int end1 = pairs[ k ].second.first;
+        const int end2 = pairs[ k ].second.second;
+        if ( links[ end1 ] < 0 && links[ end2 ] < 0 ) {
+            links[ end1 ] = end2;
+            links[ end2 ] = end1;
+        }
+    }
+
+    // Write paths of linked edges : an edge is entered by one end and left by the other one
+    EdgeList closedEdges;
+    closedEdges._edges.reserve( nbEdges );
+    closedEdges._codes.reserve( listEdges._codes.size() );
+    std::vector< uchar > isWritten( nbEdges, 0 );
+    for ( int i = 0; i < nbEdges; i++ ) {
+        if ( isWritten[ i ] ) {
+            continue;
+        }
+
+        // First end of the path (or of the cycle)
+        int first = 2 * i;
+        while ( links[ first ] >= 0 && ( links[ first ] ^ 1 ) != 2 * i ) {
+            first = links[ first ] ^ 1;
+        }
+
+        Edge& edg = closedEdges.startEdge( endX[ first ], endY[ first ] );
+        edg._minX = edg._maxX = endX[ first ];
+        edg._minY = edg._maxY = endY[ first ];
+        float sumModules = 0.0f;
+        int nbPixels = 0;
+        int end = first;
+        while ( true ) {
+            // Freeman code of the edge, reversed if it is entered by its end
+            const Edge& current = listEdges._edges[ end / 2 ];
+            isWritten[ end / 2 ] = 1;
+
+            // Statistics : the bounding box of a gap is in the bounding boxes of the edges it links
+            sumModules += current._meanModule * ( current._length + 1 );
+            nbPixels += current._length + 1;
+            edg._minX = std::min( edg._minX, current._minX );
+            edg._maxX = std::max( edg._maxX, current._maxX );
+            edg._minY = std::min( edg._minY, current._minY );
+            edg._maxY = std::max( edg._maxY, current._maxY );
+
+            if ( ( end & 1 ) == 0 ) {
+                for ( EdgeList::const_iterator itDir = listEdges.begin( current ); itDir != listEdges.end( current ); ++itDir ) {
+                    closedEdges.pushDirection( *itDir );
+                }
+            } else {
+                for ( int k = current._length - 1; k >= 0; k-- ) {
+                    closedEdges.pushDirection( ( EdgeList::readCode( listEdges._codes, current._offset + k ) + 4 ) % 8 );
+                }
+            }
+
+            // Gap to the next edge (or to the first one for a cycle)
+            const int exit = end ^ 1;
+            const int next = links[ exit ];
+            if ( next < 0 ) {
+                edg.e_x = endX[ exit ];
+                edg.e_y = endY[ exit ];
+                break;
+            }
+            pushSegment( closedEdges, endX[ exit ], endY[ exit ], endX[ next ], endY[ next ] );
+            if ( next == first ) {
+                edg.e_x = endX[ next ];
+                edg.e_y = endY[ next ];
+                break;
+            }
+            end = next;
+        }
+        edg._meanModule = sumModules / nbPixels;
+        edg._isClosed = isClosedEdge( edg );
+    }
+
+    listEdges.swap( closedEdges );
+}
+
+/******************************************************************************
+ * Polygonal approximation of edges (Douglas-Peucker), edges are processed in parallel
+ * - pixels of an edge are decoded from its Freeman code, then split recursively (explicit stack)
+ *   at the farthest pixel from the current segment while this distance is above the tolerance
+ * - polylines are in the order of edges
+ *
+ * @param listEdges list of edges
+ * @param tolerance max distance (in pixels) between an edge pixel and its segment
+ * @param polylines output polylines
+ ******************************************************************************/
+void algorithm::polygonalApproximation( const EdgeList& listEdges, float tolerance, Polylines& polylines )
+{
+    polylines.clear();
+    if ( listEdges.size() == 0 ) {
+        return;
+    }
+
+    // Approximate chunks of edges
+    const int nbChunks = std::min( listEdges.size(), 16 * std::max( 1, cv::getNumThreads() ) );
+    std::vector< Polylines > chunkPolylines( nbChunks );
+    cv::parallel_for_( cv::Range( 0, nbChunks ), PolygonalApproximationBody( listEdges, tolerance, nbChunks, &chunkPolylines[ 0 ] ) );
+
+    // Concatenate polylines
+    int nbVertices = 0;
+    for ( int chunk = 0; chunk < nbChunks; chunk++ ) {
+        nbVertices += static_cast< int >( chunkPolylines[ chunk ]._x.size() );
+    }
+    polylines._firstVertices.reserve( listEdges.size() + 1 );
+    polylines._x.reserve( nbVertices );
+    polylines._y.reserve( nbVertices );
+    polylines._errors.reserve( nbVertices );
+    for ( int chunk = 0; chunk < nbChunks; chunk++ ) {
+        const Polylines& chunkPolyline = chunkPolylines[ chunk ];
+        const int offset = static_cast< int >( polylines._x.size() );
+        for ( int i = 1; i <= chunkPolyline.size(); i++ ) {
+            polylines._firstVertices.push_back( offset + chunkPolyline._firstVertices[ i ] );
+        }
+        polylines._x.insert( polylines._x.end(), chunkPolyline._x.begin(), chunkPolyline._x.end() );
+        polylines._y.insert( polylines._y.end(), chunkPolyline._y.begin(), chunkPolyline._y.end() );
+        polylines._errors.insert( polylines._errors.end(), chunkPolyline._errors.begin(), chunkPolyline._errors.end() );
+    }
+}
+
+/******************************************************************************
+ * Polygonal approximation of an edge (Douglas-Peucker)
+ *
+ * @param listEdges list of edges
+ * @param edg the edge
+ * @param tolerance max distance (in pixels) between an edge pixel and its segment
+ * @param x buffer of lines of the edge pixels (can be reused between calls)
+ * @param y buffer of columns of the edge pixels (can be reused between calls)
+ * @param stack stack buffer (can be reused between calls)
+ * @param polylines polylines, the polyline of the edge is added at the end
+ ******************************************************************************/
+void algorithm::approximateEdge( const EdgeList& listEdges, const Edge& edg, float tolerance,
+                                 std::vector< int >& x, std::vector< int >& y, std::vector< int >& stack, Polylines& polylines )
+{
+    //Freeman directions encoding
+    static const int freemanDirections[ 8 ][ 2 ] = { {0,1}, {-1,1}, {-1,0}, {-1,-1}, {0,-1}, {1,-1}, {1,0}, {1,1} };
+
+    // Pixels of the edge
+    x.resize( edg._length + 1 );
+    y.resize( edg._length + 1 );
+    x[ 0 ] = edg.s_x;
+    y[ 0 ] = edg.s_y;
+    int i = 0;
+    for ( EdgeList::const_iterator itDir = listEdges.begin( edg ); itDir != listEdges.end( edg ); ++itDir, ++i ) {
+        x[ i + 1 ] = x[ i ] + freemanDirections[ *itDir ][ 0 ];
+        y[ i + 1 ] = y[ i ] + freemanDirections[ *itDir ][ 1 ];
+    }
+
+    // Split ranges of pixels, first half first so that vertices are added in order
+    // - a single pixel gives a single vertex
+    stack.clear();
+    if ( edg._length > 0 ) {
+        stack.push_back( edg._length );
+        stack.push_back( 0 );
+    }
+    while ( ! stack.empty() ) {
+        const int first = stack.back();
+        stack.pop_back();
+        const int last = stack.back();
+        stack.pop_back();
+
+        // Farthest pixel from the segment (from the first pixel if the segment is a single pixel)
+        const float dx = static_cast< float >( x[ last ] - x[ first ] );
+        const float dy = static_cast< float >( y[ last ] - y[ first ] );
+        const float length = sqrt( dx * dx + dy * dy );
+        float maxDistance = 0.0f;
+        int farthest = first;
+        for ( int k = first + 1; k < last; k++ ) {
+            const float px = static_cast< float >( x[ k ] - x[ first ] );
+            const float py = static_cast< float >( y[ k ] - y[ first ] );
+            const float distance = ( length > 0.0f ) ? fabs( dx * py - dy * px ) / length : sqrt( px * px + py * py );
+            if ( distance > maxDistance ) {
+                maxDistance = distance;
+                farthest = k;
+            }
+        }
+
+        if ( maxDistance > tolerance ) {
+            stack.push_back( last );
+            stack.push_back( farthest );
+            stack.push_back( farthest );
+            stack.push_back( first );
+        } else {
+            polylines.pushVertex( x[ first ], y[ first ], maxDistance );
+        }
+    }
+    polylines.pushVertex( x[ edg._length ], y[ edg._length ], 0.0f );
+    polylines.endPolyline();
 }
 
 /******************************************************************************
@@ -1067,7 +3602,10 @@ void algorithm::displayMat( const char* text, cv::Mat& src, bool binaire)
 {
 	// Output image
     cv::Mat res;
-    if ( src.channels() == 1 ) {
+    if ( src.depth() == CV_8U ) {
+		// Unsigned char data are displayed as is
+        res = src;
+    } else if ( src.channels() == 1 ) {
 		// Unsigned char with 1 component (i.e. grayscale)
         res = cv::Mat( src.rows, src.cols, 0 );
     } else {
@@ -1077,7 +3615,7 @@ void algorithm::displayMat( const char* text, cv::Mat& src, bool binaire)
 
 	// Transform data from "float" to "unsigned char"
 	// Iterate through channels
-    for ( int i = 0; i < src.channels(); i++ ) {
+    for ( int i = 0; src.depth() != CV_8U && i < src.channels(); i++ ) {
 		// Iterate through lines
         for (int x = 0; x < src.rows; x++) {
 			// Iterate through columns
@@ -1117,6 +3655,38 @@ void algorithm::displayMat( const char* text, cv::Mat& src, bool binaire)
     res.~Mat();
 }
 
+/******************************************************************************
+ * Helper function to display data (i.e. image) rescaled between 0 and 255 in a window
+ * - data are rescaled during the conversion to "unsigned char" (no normalized copy)
+ *
+ * @param text window title
+ * @param src input data (grayscale)
+ ******************************************************************************/
+void algorithm::displayNormalizedMat( const char* text, const cv::Mat& src )
+{
+	// Find min and max values
+    float min;
+    float max;
+    minMax( src, min, max );
+
+	// Output image : unsigned char with 1 component (i.e. grayscale)
+    cv::Mat res = cv::Mat( src.rows, src.cols, CV_8U );
+
+	// Transform data from "float" to "unsigned char"
+	// Iterate through lines
+    for ( int x = 0; x < src.rows; x++ ) {
+        const float* srcRow = src.ptr< float >( x );
+        uchar* resRow = res.ptr< uchar >( x );
+		// Iterate through columns
+        for ( int y = 0; y < src.cols; y++ ) {
+            resRow[ y ] = ( max > min ) ? (uchar)( ( srcRow[ y ] - min ) / ( max - min ) * 255.0f ) : 0;
+        }
+    }
+
+	// Display image in a window
+    cv::imshow( text, res );
+}
+
 /******************************************************************************
  * Trace all the egdes of a vector
  *
@@ -1124,7 +3694,7 @@ void algorithm::displayMat( const char* text, cv::Mat& src, bool binaire)
  *
  * @return matrix with edges
  ******************************************************************************/
-cv::Mat algorithm::traceEdges( const std::vector<algorithm::Edge>& listEdges, int height, int width )
+cv::Mat algorithm::traceEdges( const EdgeList& listEdges, int height, int width )
 {
     cv::Mat res = cv::Mat( height, width, CV_8U );
     res.setTo(0);
@@ -1135,15 +3705,14 @@ cv::Mat algorithm::traceEdges( const std::vector<algorithm::Edge>& listEdges, in
     //Freeman directions encoding
     static const int freemanDirections[ 8 ][ 2 ] = { {0,1}, {-1,1}, {-1,0}, {-1,-1}, {0,-1}, {1,-1}, {1,0}, {1,1} };
 
-    std::vector< ushort >::const_iterator itDir;
     std::vector<algorithm::Edge>::const_iterator itEdg;
-    for(itEdg = listEdges.begin(); itEdg!=listEdges.end(); ++itEdg){
+    for(itEdg = listEdges._edges.begin(); itEdg!=listEdges._edges.end(); ++itEdg){
         _x = itEdg->s_x;
         _y = itEdg->s_y;
 
         res.at< uchar >( _x, _y ) = 255;
 
-        for(itDir = itEdg->_directions.begin(); itDir!=itEdg->_directions.end(); ++itDir){
+        for(EdgeList::const_iterator itDir = listEdges.begin( *itEdg ); itDir!=listEdges.end( *itEdg ); ++itDir){
 
             _x += freemanDirections[*itDir][0];
             _y += freemanDirections[*itDir][1];
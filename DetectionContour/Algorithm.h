@@ -27,6 +27,7 @@
 #endif
 
 // STL
+#include <algorithm>
 #include <vector>
 
 /******************************************************************************
@@ -41,6 +42,9 @@
  ******************************** CLASS USED **********************************
  ******************************************************************************/
 
+// Project
+class Histogram;
+
 /******************************************************************************
  ****************************** CLASS DEFINITION ******************************
  ******************************************************************************/
@@ -61,10 +65,15 @@ public:
 
     /**
      * @brief The Edge struct
+     * - its Freeman code is stored in the packed code stream of the EdgeList owning it
      */
     struct Edge
     {
-        Edge() : _directions() {}
+        Edge()
+        :   s_x( 0 ), s_y( 0 ), e_x( 0 ), e_y( 0 ), _offset( 0 ), _length( 0 )
+        ,   _meanModule( 0.0f ), _minX( 0 ), _minY( 0 ), _maxX( 0 ), _maxY( 0 ), _isClosed( false )
+        {
+        }
 
         /**
          * Pixel start position
@@ -77,11 +86,371 @@ public:
         int e_x,e_y;
 
         /**
-         *  Freeman code : encode the change of directions
+         * Freeman code : index of the first direction in the code stream, and number of directions
+         */
+        int _offset;
+        int _length;
+
+        /**
+         * Statistics, computed while the edge is traced
+         * - mean module of the traced pixels (pixels added by an edge closure have no module)
+         * - bounding box (lines and columns)
+         * - flag telling whether or not the edge is closed (end next to the start, at least 3 pixels)
+         */
+        float _meanModule;
+        int _minX, _minY, _maxX, _maxY;
+        bool _isClosed;
+    };
+
+    /**
+     * @brief The EdgeList struct : all edges of an image, in a single arena
+     * - Freeman codes of all edges are packed in one bit stream, 3 bits per direction
+     * - clear() keeps the memory, so that a list can be reused between images
+     */
+    struct EdgeList
+    {
+        /**
+         * @brief Iterator through the Freeman code of an edge
+         */
+        class const_iterator
+        {
+        public:
+
+            const_iterator( const std::vector< unsigned int >& pCodes, int pIndex ) : _codes( &pCodes ), _index( pIndex ) {}
+
+            /**
+             * Get the current direction
+             *
+             * @return the current direction (Freeman code in [0,7])
+             */
+            int operator*() const { return EdgeList::readCode( *_codes, _index ); }
+
+            const_iterator& operator++() { ++_index; return *this; }
+
+            bool operator==( const const_iterator& pOther ) const { return _index == pOther._index; }
+
+            bool operator!=( const const_iterator& pOther ) const { return _index != pOther._index; }
+
+        private:
+
+            /**
+             * Code stream and index of the current direction
+             */
+            const std::vector< unsigned int >* _codes;
+            int _index;
+        };
+
+        EdgeList() : _edges(), _codes(), _nbCodes( 0 ) {}
+
+        /**
+         * List of edges
+         */
+        std::vector< Edge > _edges;
+
+        /**
+         * Packed Freeman codes of all edges (3 bits per direction, a direction may straddle two words)
+         */
+        std::vector< unsigned int > _codes;
+
+        /**
+         * Number of directions in the code stream
+         */
+        int _nbCodes;
+
+        /**
+         * Get the number of edges
+         *
+         * @return the number of edges
+         */
+        int size() const { return static_cast< int >( _edges.size() ); }
+
+        /**
+         * Remove all edges (memory is kept)
+         */
+        void clear()
+        {
+            _edges.clear();
+            _codes.clear();
+            _nbCodes = 0;
+        }
+
+        /**
+         * Exchange the content of two lists (no copy)
+         *
+         * @param pOther the other list
+         */
+        void swap( EdgeList& pOther )
+        {
+            _edges.swap( pOther._edges );
+            _codes.swap( pOther._codes );
+            std::swap( _nbCodes, pOther._nbCodes );
+        }
+
+        /**
+         * Remove the last edge and its Freeman code (memory is kept)
+         */
+        void popEdge()
+        {
+            _nbCodes = _edges.back()._offset;
+            _edges.pop_back();
+            const int nbBits = 3 * _nbCodes;
+            _codes.resize( ( nbBits + 31 ) / 32 );
+            if ( ( nbBits & 31 ) != 0 ) {
+                _codes.back() &= ( 1u << ( nbBits & 31 ) ) - 1;
+            }
+        }
+
+        /**
+         * Start a new edge at the end of the list, its Freeman code is empty
+         *
+         * @param pX line of the start pixel
+         * @param pY column of the start pixel
+         *
+         * @return the new edge
+         */
+        Edge& startEdge( int pX, int pY )
+        {
+            _edges.push_back( Edge() );
+            Edge& edg = _edges.back();
+            edg.s_x = edg.e_x = pX;
+            edg.s_y = edg.e_y = pY;
+            edg._offset = _nbCodes;
+            return edg;
+        }
+
+        /**
+         * Add a direction to the Freeman code of the last edge
+         *
+         * @param pDirection Freeman code in [0,7]
+         */
+        void pushDirection( int pDirection )
+        {
+            const int bit = 3 * _nbCodes;
+            if ( static_cast< int >( _codes.size() ) * 32 < bit + 3 ) {
+                _codes.push_back( 0 );
+            }
+            const unsigned int code = static_cast< unsigned int >( pDirection ) & 7;
+            const int shift = bit & 31;
+            _codes[ bit >> 5 ] |= code << shift;
+            if ( shift > 29 ) {
+                _codes[ ( bit >> 5 ) + 1 ] |= code >> ( 32 - shift );
+            }
+            _nbCodes++;
+            _edges.back()._length++;
+        }
+
+        /**
+         * Get an iterator on the first direction of an edge
+         *
+         * @param pEdge an edge of the list
+         *
+         * @return the iterator
+         */
+        const_iterator begin( const Edge& pEdge ) const { return const_iterator( _codes, pEdge._offset ); }
+
+        /**
+         * Get an iterator past the last direction of an edge
+         *
+         * @param pEdge an edge of the list
+         *
+         * @return the iterator
+         */
+        const_iterator end( const Edge& pEdge ) const { return const_iterator( _codes, pEdge._offset + pEdge._length ); }
+
+        /**
+         * Read a direction in a code stream
+         *
+         * @param pCodes code stream
+         * @param pIndex index of the direction
+         *
+         * @return the direction (Freeman code in [0,7])
+         */
+        static int readCode( const std::vector< unsigned int >& pCodes, int pIndex )
+        {
+            const int bit = 3 * pIndex;
+            const int shift = bit & 31;
+            unsigned int code = pCodes[ bit >> 5 ] >> shift;
+            if ( shift > 29 ) {
+                code |= pCodes[ ( bit >> 5 ) + 1 ] << ( 32 - shift );
+            }
+            return static_cast< int >( code & 7 );
+        }
+    };
+
+    /**
+     * @brief The Polylines struct : polygonal approximations of all edges of an image
+     * - structure of arrays, vertices of all polylines are stored one after another
+     * - clear() keeps the memory, so that polylines can be reused between images
+     */
+    struct Polylines
+    {
+        Polylines() : _firstVertices( 1, 0 ), _x(), _y(), _errors() {}
+
+        /**
+         * Index of the first vertex of each polyline (and total number of vertices at the end)
+         */
+        std::vector< int > _firstVertices;
+
+        /**
+         * Vertex positions (line and column)
+         */
+        std::vector< int > _x;
+        std::vector< int > _y;
+
+        /**
+         * Error of the segment starting at each vertex : max distance of the edge pixels it replaces
+         * (0 for the last vertex of a polyline)
+         */
+        std::vector< float > _errors;
+
+        /**
+         * Get the number of polylines
+         *
+         * @return the number of polylines
+         */
+        int size() const { return static_cast< int >( _firstVertices.size() ) - 1; }
+
+        /**
+         * Remove all polylines (memory is kept)
+         */
+        void clear()
+        {
+            _firstVertices.assign( 1, 0 );
+            _x.clear();
+            _y.clear();
+            _errors.clear();
+        }
+
+        /**
+         * Add a vertex to the last polyline
+         *
+         * @param pX line of the vertex
+         * @param pY column of the vertex
+         * @param pError error of the segment starting at the vertex
+         */
+        void pushVertex( int pX, int pY, float pError )
+        {
+            _x.push_back( pX );
+            _y.push_back( pY );
+            _errors.push_back( pError );
+        }
+
+        /**
+         * End the last polyline (the next vertices belong to a new one)
+         */
+        void endPolyline() { _firstVertices.push_back( static_cast< int >( _x.size() ) ); }
+    };
+
+    /**
+     * @brief The EdgePixels struct : sparse list of edge pixels (non null data), in raster order
+     * - structure of arrays, so that consumers only iterate through edge pixels instead of the whole image
+     * - clear() keeps the memory, so that a list can be reused between images
+     */
+    struct EdgePixels
+    {
+        EdgePixels() : _nbRows( 0 ), _nbColumns( 0 ), _x(), _y(), _modules(), _directions() {}
+
+        /**
+         * Size of the image
+         */
+        int _nbRows, _nbColumns;
+
+        /**
+         * Pixel positions (line and column)
+         */
+        std::vector< int > _x;
+        std::vector< int > _y;
+
+        /**
+         * Pixel modules
+         */
+        std::vector< float > _modules;
+
+        /**
+         * Pixel direction codes (cNullDirection if unknown)
+         */
+        std::vector< uchar > _directions;
+
+        /**
+         * Get the number of edge pixels
+         *
+         * @return the number of edge pixels
+         */
+        int size() const { return static_cast< int >( _x.size() ); }
+
+        /**
+         * Remove all edge pixels (memory is kept)
+         *
+         * @param pNbRows number of lines of the image
+         * @param pNbColumns number of columns of the image
          */
-        std::vector< unsigned short > _directions;
+        void clear( int pNbRows, int pNbColumns )
+        {
+            _nbRows = pNbRows;
+            _nbColumns = pNbColumns;
+            _x.clear();
+            _y.clear();
+            _modules.clear();
+            _directions.clear();
+        }
+
+        /**
+         * Add an edge pixel
+         *
+         * @param pX line of the pixel
+         * @param pY column of the pixel
+         * @param pModule module of the pixel
+         * @param pDirection direction code of the pixel
+         */
+        void push_back( int pX, int pY, float pModule, uchar pDirection )
+        {
+            _x.push_back( pX );
+            _y.push_back( pY );
+            _modules.push_back( pModule );
+            _directions.push_back( pDirection );
+        }
+    };
+
+    /**
+     * Classes of pixels for a hysteresis threshold
+     */
+    enum HysteresisClass
+    {
+        eNoEdge = 0,
+        eWeakEdge,
+        eStrongEdge,
+        eConnectedEdge  // strong edge, or weak edge connected to a strong edge
     };
 
+    /**
+     * Norm types used to compute the module of the gradient
+     * - NOTE : same values as Pipeline::NormType
+     */
+    enum NormType
+    {
+        eLInfinity = 0,
+        eL1,
+        eL2,
+        eNbNormTypes
+    };
+
+    /**
+     * Direction code of a null slope
+     * - direction code : 45 degrees sector of the slope, i.e. 4 + floor( slope / ( PI / 4 ) ) for positive slopes
+     *   and 3 - floor( -slope / ( PI / 4 ) ) for negative ones (from 0 to 8, 8 and 0 give the same Freeman direction)
+     */
+    static const uchar cNullDirection = 4;
+
+    /**
+     * Max direction code (slope PI)
+     */
+    static const uchar cMaxDirection = 8;
+
+    /**
+     * Number of Freeman directions used to estimate the tangent at an end of an edge
+     */
+    static const int cTangentLength = 5;
+
 	/******************************* ATTRIBUTES *******************************/
 
     /**
@@ -99,6 +468,48 @@ public:
      */
     static float _lowThresholdPercent;
 
+    /**
+     * Ratio of the low threshold to the high (Otsu) threshold of the automatic hysteresis threshold
+     */
+    static float _otsuHysteresisLowRatio;
+
+    /**
+     * Number of bins of the histograms used by threshold methods (over [0,256[)
+     * - more bins than gray levels give thresholds finer than 1 on float data
+     */
+    static int _histogramNbBins;
+
+    /**
+     * Flag telling whether or not to approximate the square root of the L2 norm
+     * (reciprocal square root refined by one Newton step)
+     */
+    static bool _useFastL2Norm;
+
+    /**
+     * Flag telling whether or not to process the hysteresis threshold with bands of lines in parallel
+     */
+    static bool _useParallelHysteresis;
+
+    /**
+     * Flag telling whether or not to extract edges with connected components traced in parallel
+     */
+    static bool _useParallelEdgeExtraction;
+
+    /**
+     * Max angle (in degrees) between the tangent at an end of an edge and the gap to bridge, when edges are linked by their ends
+     */
+    static float _edgeClosureMaxAngle;
+
+    /**
+     * Min length (in pixels) of an edge, shorter edges are dropped as soon as they are traced
+     */
+    static int _edgeMinLength;
+
+    /**
+     * Min contrast (mean module) of an edge, edges of lower contrast are dropped as soon as they are traced
+     */
+    static float _edgeMinContrast;
+
 	/******************************** METHODS *********************************/
 
 	/**
@@ -117,6 +528,35 @@ public:
 	 */
     static cv::Mat filter( const cv::Mat& src, const cv::Mat& filter );
 	
+    /**
+     * Gradient computation - Convolution with a set of directional kernels
+     * - each 3x3 neighborhood is read once and all directions are written together
+     * - line operations go through the SIMD backend of Convolution
+     *
+     * @param src input image
+     * @param kernels list of 3x3 directional kernels
+     * @param NbDirection number of directions
+     * @param gradients output list of directional components of the gradient
+     */
+    static void gradient( const cv::Mat& src, const cv::Mat* kernels, int NbDirection, cv::Mat* gradients );
+
+    /**
+     * Gradient computation - Module and direction in a single pass
+     * - directional components are only kept line by line, unless requested
+     *
+     * @param src input image
+     * @param kernels list of 3x3 directional kernels
+     * @param NbDirection number of directions
+     * @param norm norm used to compute the module
+     * @param module output normalized module
+     * @param direction output direction code (not masked by the module)
+     * @param slope optional output slope (not masked by the module, NULL if not required)
+     * @param gradients optional output list of directional components of the gradient (NULL if not required)
+     * @param nbGradients number of directional components written in gradients, from the first one
+     *        (e.g. 2 when only X and Y components are required, ignored if gradients is NULL)
+     */
+    static void gradientModule( const cv::Mat& src, const cv::Mat* kernels, int NbDirection, NormType norm, cv::Mat& module, cv::Mat& direction, cv::Mat* slope, cv::Mat* gradients, int nbGradients );
+
 	/**
 	 * Normalize a matrice (i.e. an image)
 	 *
@@ -135,6 +575,16 @@ public:
      */
     static cv::Mat normalizeData( const cv::Mat& src );
 
+    /**
+     * Find the min and max values of a matrice (i.e. an image)
+     * - bands of lines are reduced in parallel, then results are merged
+     *
+     * @param src input matrice
+     * @param min output min value
+     * @param max output max value
+     */
+    static void minMax( const cv::Mat& src, float& min, float& max );
+
     /**
      * Set every pixels of a matrice to 0.0 or 255.0
      *
@@ -168,6 +618,20 @@ public:
 	 * @return the module
 	 */
 	static cv::Mat moduleL1( cv::Mat* modules, int NbDirection );
+
+	/**
+	 * Generate the module with norm "L2" given a set of components
+	 * - i.e. for each pixel, compute the square root of the sum of squared components
+	 *
+	 * NOTE : for multidirectional filtering, first find the 2 max components, then compute classical L2 norm
+	 * NOTE : the square root is approximated if _useFastL2Norm is set
+	 *
+	 * @param modules list of module components
+	 * @param NbDirection nulber of directions
+	 *
+	 * @return the module
+	 */
+	static cv::Mat moduleL2( cv::Mat* modules, int NbDirection );
     
 	/**
 	 * Generate the slope given a module
@@ -182,14 +646,33 @@ public:
     static cv::Mat pente(cv::Mat* pentes, int NbDirection, const cv::Mat& module );
 
     /**
-     * Generate the slope given a module
+     * Generate the color image of the slope given a module
+     * - 8 bits color of the direction code (lookup table) scaled by the module
      *
-     * @param slope input slope
+     * @param direction input direction code
      * @param module input module
      *
-     * @return the matrice color
+     * @return the matrice color (CV_8UC3)
      */
-    static cv::Mat colorMat(const cv::Mat& slope, const cv::Mat& module );
+    static cv::Mat colorMat(const cv::Mat& direction, const cv::Mat& module );
+
+    /**
+     * Apply a mask to a slope
+     * - i.e. slope is set to 0 where the module is 0
+     *
+     * @param slope slope to mask (in place)
+     * @param module input module
+     */
+    static void maskSlope( cv::Mat& slope, const cv::Mat& module );
+
+    /**
+     * Apply a mask to a direction code
+     * - i.e. direction code is set to the one of a null slope where the module is 0
+     *
+     * @param direction direction code to mask (in place)
+     * @param module input module
+     */
+    static void maskDirection( cv::Mat& direction, const cv::Mat& module );
 
     /**
      * Apply a threshold given an input dataset with a "local" criteria
@@ -213,7 +696,58 @@ public:
 	 *
 	 * @return the computed threshold 
 	 */
-    static int globalThreshold(const cv::Mat& src , float percentFilter);
+    static float globalThreshold(const cv::Mat& src , float percentFilter);
+
+	/**
+	 * Determine a threshold given the histogram of an input dataset with a "global" criteria
+	 * - users have to specify a percentage of valid pixels
+	 *
+	 * @param histogram histogram of input data
+	 * @param percentFilter percentage of valid pixels
+	 *
+	 * @return the computed threshold
+	 */
+    static float globalThreshold( const Histogram& histogram, float percentFilter );
+
+	/**
+	 * Determine a threshold given an input dataset with the Otsu criteria
+	 * - maximize the between-class variance of the two classes of data
+	 *
+	 * @param src input data
+	 *
+	 * @return the computed threshold
+	 */
+    static float otsuThreshold( const cv::Mat& src );
+
+	/**
+	 * Determine a threshold given the histogram of an input dataset with the Otsu criteria
+	 * - O(bins) thanks to the cumulative counts and weighted sums of the histogram
+	 *
+	 * @param histogram histogram of input data
+	 *
+	 * @return the computed threshold (data below are rejected)
+	 */
+    static float otsuThreshold( const Histogram& histogram );
+
+	/**
+	 * Determine a threshold given an input dataset with the Kapur entropy criteria
+	 * - maximize the sum of the entropies of the two classes of data
+	 *
+	 * @param src input data
+	 *
+	 * @return the computed threshold
+	 */
+    static float entropyThreshold( const cv::Mat& src );
+
+	/**
+	 * Determine a threshold given the histogram of an input dataset with the Kapur entropy criteria
+	 * - O(bins) with a single cumulative pass over the bins
+	 *
+	 * @param histogram histogram of input data
+	 *
+	 * @return the computed threshold (data below are rejected)
+	 */
+    static float entropyThreshold( const Histogram& histogram );
 
 	/**
 	 * Apply a threshold given an input dataset
@@ -221,7 +755,7 @@ public:
 	 * @param input data to threshold
 	 * @param threshold
 	 */
-    static void applyThreshold( cv::Mat* src, int seuil );
+    static void applyThreshold( cv::Mat* src, float seuil );
 
     /**
      * Apply a threshold on a given input dataset
@@ -231,16 +765,56 @@ public:
      *
      * @return the thresholded data
      */
-     static cv::Mat applyThreshold( const cv::Mat& pData, int pThreshold );
+     static cv::Mat applyThreshold( const cv::Mat& pData, float pThreshold );
+
+    /**
+     * Apply a threshold on a given input dataset into an output buffer
+     * - no copy : the output may be the input (in place) or a buffer reused between calls
+     *
+     * @param pData input data
+     * @param pThreshold threshold (data below are set to 0)
+     * @param pResult thresholded data (allocated if its size or type does not match)
+     */
+    static void applyThreshold( const cv::Mat& pData, float pThreshold, cv::Mat& pResult );
 
     /**
      *  Hysteresis Threshold filtering : Return a Matrice made with a high filter and a low filter
+     * - pixels above the low threshold are kept if 8-connected to a pixel above the high threshold
+     *
+     * @param src The matrice on wich we apply the Threshold
+     * @param classes buffer of the classes of pixels (owned by the caller, reallocated only if the size changes)
+     * @param stack buffer of the flood fill (owned by the caller, grown only if required)
+     *
+     * @return res The matrice filtered
+     */
+    static cv::Mat hysteresis( const cv::Mat& src, float& pHysteresisHighThreshold, float& pHysteresisLowThreshold, cv::Mat& classes, std::vector< int >& stack );
+
+    /**
+     * Automatic hysteresis threshold filtering
+     * - the high threshold is the Otsu threshold, the low one is a ratio of it (_otsuHysteresisLowRatio)
      *
      * @param src The matrice on wich we apply the Threshold
+     * @param pHysteresisHighThreshold computed high threshold
+     * @param pHysteresisLowThreshold computed low threshold
+     * @param classes buffer of the classes of pixels (owned by the caller, reallocated only if the size changes)
+     * @param stack buffer of the flood fill (owned by the caller, grown only if required)
      *
      * @return res The matrice filtered
      */
-    static cv::Mat hysteresis( const cv::Mat& src, int& pHysteresisHighThreshold, int& pHysteresisLowThreshold );
+    static cv::Mat otsuHysteresis( const cv::Mat& src, float& pHysteresisHighThreshold, float& pHysteresisLowThreshold, cv::Mat& classes, std::vector< int >& stack );
+
+    /**
+     * Hysteresis threshold filtering with given thresholds
+     *
+     * @param src The matrice on wich we apply the Threshold
+     * @param pHighThreshold high threshold
+     * @param pLowThreshold low threshold
+     * @param classes buffer of the classes of pixels (owned by the caller, reallocated only if the size changes)
+     * @param stack buffer of the flood fill (owned by the caller, grown only if required)
+     *
+     * @return res The matrice filtered
+     */
+    static cv::Mat applyHysteresis( const cv::Mat& src, float pHighThreshold, float pLowThreshold, cv::Mat& classes, std::vector< int >& stack );
 
     /**
      * Suppression of pixels whitout others in n-ring neighborhood
@@ -249,32 +823,130 @@ public:
      */
     static void supprIsoletedPoints( cv::Mat& src, int n );
 
+    /**
+     * Suppression of pixels whitout others in n-ring neighborhood, in a separate output
+     * - a pixel is suppressed if its (2n+1)x(2n+1) neighborhood has at most n non null data (pixel included)
+     * - counts are given by a summed area table of the binary mask, so the cost does not depend on n
+     *
+     * @param src input data
+     * @param n size of the ring neighborhood
+     * @param dst output data (must not be the input)
+     */
+    static void supprIsoletedPoints( const cv::Mat& src, int n, cv::Mat& dst );
+
     /**
      * extract all the local extremum
      *
-     * @param slope matrix of the slope value
+     * @param direction matrix of the direction codes
+     * @param module input module
+     */
+    static cv::Mat localExtremum( const cv::Mat& direction, const cv::Mat& module );
+
+    /**
+     * Non-maximum suppression of the module along the gradient direction
+     * - the two neighbors across the edge are selected from the gradient components (comparisons only)
+     * - either the nearest neighbors (direction quantized in 4 sectors), or neighbors interpolated
+     *   between the two nearest pixels of the 8-neighborhood along the true gradient direction
+     * - borders are kept
+     *
+     * @param gx horizontal components of the gradient
+     * @param gy vertical components of the gradient
      * @param module input module
+     * @param dst output module (allocated if its size or type does not match, must not be the input)
+     * @param interpolate flag telling whether or not to interpolate neighbors
+     * @param edgePixels output list of edge pixels of the output module, with their direction codes (optional)
+     */
+    static void nonMaximumSuppression( const cv::Mat& gx, const cv::Mat& gy, const cv::Mat& module, cv::Mat& dst, bool interpolate, EdgePixels* edgePixels = NULL );
+
+    /**
+     * Extract the sparse list of edge pixels (non null data) of an image
+     *
+     * @param src input data
+     * @param direction direction codes of the input data (cNullDirection for all pixels if NULL)
+     * @param edgePixels output list of edge pixels
      */
-    static cv::Mat localExtremum( const cv::Mat& slope, const cv::Mat& module );
+    static void extractEdgePixels( const cv::Mat& src, const cv::Mat* direction, EdgePixels& edgePixels );
 
     /**
      * Detect all edges in the Matrix
      *
      * @param src input matrix
+     * @param listEdges output list of edges
+     */
+    static void freemanEncoding( cv::Mat& src, EdgeList& listEdges );
+
+    /**
+     * Detect all edges in the Matrix, given its list of edge pixels
+     * - edges are started from edge pixels instead of scanning the whole matrix (same result)
+     * - connected components are traced in parallel if required (see _useParallelEdgeExtraction)
      *
-     * @result list of edges
+     * @param src input matrix
+     * @param edgePixels list of edge pixels of the input matrix
+     * @param listEdges output list of edges
      */
-    static std::vector<Edge> freemanEncoding( cv::Mat& src );
+    static void freemanEncoding( cv::Mat& src, const EdgePixels& edgePixels, EdgeList& listEdges );
+
+    /**
+     * Detect all edges in the Matrix, with connected components traced in parallel
+     * - 8-connected components of edge pixels are labelled with bands of lines in parallel (union-find across band borders),
+     *   then chunks of components trace their edges in parallel (dynamic scheduling of chunks)
+     * - edges are then ordered by start pixel in raster order : same result as the serial version
+     *
+     * @param src input matrix
+     * @param edgePixels list of edge pixels of the input matrix
+     * @param listEdges output list of edges
+     */
+    static void freemanEncodingParallel( cv::Mat& src, const EdgePixels& edgePixels, EdgeList& listEdges );
 
     /**
      * Connect every edge close to each other
      *
      * @param listEdges list of all edges already exist
      * @param src binary matrice of edges
-     * @param slope matrice of gradient directions
+     * @param direction matrice of gradient direction codes
      * @param nbIterations number of iterations for the algorithm
      */
-    static void edgesClosure(std::vector<algorithm::Edge>& listEdges, const cv::Mat& src, const cv::Mat& slope, int nbIterations );
+    static void edgesClosure(EdgeList& listEdges, const cv::Mat& src, const cv::Mat& direction, int nbIterations );
+
+    /**
+     * Connect edges by linking their ends
+     * - ends of open edges are indexed in a grid of cells of the max gap size, so only close ends are compared
+     * - a pair of ends costs its gap (relative to the max gap) plus the deviation of the gap from the tangent at each end,
+     *   pairs are linked by increasing cost while both ends are free (an edge may be closed on itself)
+     * - linked edges are written once, in path order, in a new arena (no Freeman code is ever prepended)
+     *
+     * @param listEdges list of all edges already exist
+     * @param height number of lines of the image
+     * @param width number of columns of the image
+     * @param maxDistance max gap between linked ends (in pixels)
+     */
+    static void edgesClosureByEndpoints( EdgeList& listEdges, int height, int width, int maxDistance );
+
+    /**
+     * Polygonal approximation of edges (Douglas-Peucker), edges are processed in parallel
+     * - pixels of an edge are decoded from its Freeman code, then split recursively (explicit stack)
+     *   at the farthest pixel from the current segment while this distance is above the tolerance
+     * - polylines are in the order of edges
+     *
+     * @param listEdges list of edges
+     * @param tolerance max distance (in pixels) between an edge pixel and its segment
+     * @param polylines output polylines
+     */
+    static void polygonalApproximation( const EdgeList& listEdges, float tolerance, Polylines& polylines );
+
+    /**
+     * Polygonal approximation of an edge (Douglas-Peucker)
+     *
+     * @param listEdges list of edges
+     * @param edg the edge
+     * @param tolerance max distance (in pixels) between an edge pixel and its segment
+     * @param x buffer of lines of the edge pixels (can be reused between calls)
+     * @param y buffer of columns of the edge pixels (can be reused between calls)
+     * @param stack stack buffer (can be reused between calls)
+     * @param polylines polylines, the polyline of the edge is added at the end
+     */
+    static void approximateEdge( const EdgeList& listEdges, const Edge& edg, float tolerance,
+                                 std::vector< int >& x, std::vector< int >& y, std::vector< int >& stack, Polylines& polylines );
 
     /**
      * Helper function to display data (i.e. image) in a window
@@ -286,6 +958,15 @@ public:
      */
     static void displayMat(const char* text, cv::Mat& src, bool binaire);
 
+    /**
+     * Helper function to display data (i.e. image) rescaled between 0 and 255 in a window
+     * - data are rescaled during the conversion to "unsigned char" (no normalized copy)
+     *
+     * @param text window title
+     * @param src input data (grayscale)
+     */
+    static void displayNormalizedMat( const char* text, const cv::Mat& src );
+
     /**
      * Trace all the egdes of a vector
      *
@@ -293,7 +974,7 @@ public:
      *
      * @return matrix with edges
      */
-    static cv::Mat traceEdges(const std::vector<Edge>& listEdges , int height, int width);
+    static cv::Mat traceEdges(const EdgeList& listEdges , int height, int width);
 
 	/**************************************************************************
 	 **************************** PROTECTED SECTION ***************************
@@ -301,20 +982,226 @@ public:
 
     /**
      * Follow an edge to an end
+     * - statistics of the edge are computed on the way, then the edge is removed
+     *   if it is shorter than _edgeMinLength or its contrast is lower than _edgeMinContrast
      *
      * @param src input matrix
      * @param dejaVue matrix of pixels already seen
-     * @param edg Edge to folow
+     * @param listEdges list of edges, the edge to follow is the last one
      */
-    static void freemanEdges(cv::Mat& src, cv::Mat& dejaVue, Edge& edg);
+    static void freemanEdges(cv::Mat& src, cv::Mat& dejaVue, EdgeList& listEdges);
 
 protected:
 
 	/****************************** INNER TYPES *******************************/
 
+    /**
+     * Directional kernels decomposed on the differences and the sums of opposite neighbors,
+     * used to compute all directional components of the gradient line by line
+     */
+    class DirectionalKernels
+    {
+
+    public:
+
+        /**
+         * Check whether or not directional kernels can be decomposed
+         *
+         * @param src input image
+         * @param kernels list of directional kernels
+         * @param NbDirection number of directions
+         *
+         * @return a flag telling whether or not kernels can be decomposed
+         */
+        static bool isValid( const cv::Mat& src, const cv::Mat* kernels, int NbDirection );
+
+        /**
+         * Constructor
+         *
+         * @param kernels list of 3x3 directional kernels
+         * @param NbDirection number of directions
+         * @param width number of pixels of a line
+         */
+        DirectionalKernels( const cv::Mat* kernels, int NbDirection, int width );
+
+        /**
+         * Compute all directional components of a line (except its border)
+         * - line operations go through the SIMD backend of Convolution
+         *
+         * @param src input image
+         * @param x index of the line (must not be on the border)
+         * @param directions output lines (one per direction)
+         */
+        void computeRow( const cv::Mat& src, int x, float** directions );
+
+    protected:
+
+        /**
+         * Number of shared lines of data (differences, sums and center)
+         */
+        static const int cNbData = 9;
+
+        /**
+         * Opposite neighbors pairs
+         */
+        static const int cPairs[ 4 ][ 2 ];
+
+        /**
+         * Number of directions
+         */
+        int _nbDirections;
+
+        /**
+         * Shared lines of data used by each direction and their coefficients
+         */
+        std::vector< int > _terms[ 4 ];
+        std::vector< float > _coefficients[ 4 ];
+
+        /**
+         * Flags telling whether or not a shared line of data is used
+         */
+        bool _isUsed[ cNbData ];
+
+        /**
+         * Shared lines of data (differences and sums)
+         */
+        cv::Mat _data;
+
+    };
+
 	/******************************* ATTRIBUTES *******************************/
 
 	/******************************** METHODS *********************************/
+
+    /**
+     * Check whether or not a 3x3 kernel is separable (i.e. of rank 1)
+     * - if so, the kernel is factorised as the product of a column and a row vector
+     *
+     * @param filter kernel
+     * @param column output vertical 1D kernel (3 values)
+     * @param row output horizontal 1D kernel (3 values)
+     *
+     * @return a flag telling whether or not the kernel is separable
+     */
+    static bool isSeparable( const cv::Mat& filter, float* column, float* row );
+
+    /**
+     * Image filtering - Convolution with a separable 3x3 kernel
+     * - horizontal pass, then vertical pass on a rolling window of 3 lines
+     *
+     * @param src input image that will be filtered by a kernel
+     * @param column vertical 1D kernel (3 values)
+     * @param row horizontal 1D kernel (3 values)
+     *
+     * @return output filtered data
+     */
+    static cv::Mat filterSeparable( const cv::Mat& src, const float* column, const float* row );
+
+    /**
+     * Generate the module of a line given a set of components (not normalized)
+     * - max (L-infinity) and 2 max components (L1, L2) are selected with min/max networks (no branch)
+     * - min and max values of the module are updated in the same pass
+     *
+     * @param directions list of lines of module components
+     * @param NbDirection number of directions
+     * @param norm norm used to compute the module
+     * @param dst output line
+     * @param width number of pixels of a line
+     * @param min min value of the module (updated)
+     * @param max max value of the module (updated)
+     */
+    static void moduleRow( const float* const* directions, int NbDirection, NormType norm, float* dst, int width, float& min, float& max );
+
+    /**
+     * Rescale a line between 0 and 255 given the min and max values of the image
+     * - lines are set to 0 if the image is uniform
+     *
+     * @param src input line
+     * @param dst output line (can be the input line)
+     * @param width number of pixels of a line
+     * @param min min value of the image
+     * @param max max value of the image
+     */
+    static void rescaleRow( const float* src, float* dst, int width, float min, float max );
+
+    /**
+     * Generate the direction code of a line given the first two directional components
+     * - only sign and ratio comparisons of the components are used (no trigonometry)
+     *
+     * @param gx line of horizontal components
+     * @param gy line of vertical components
+     * @param dst output line of direction codes
+     * @param width number of pixels of a line
+     */
+    static void directionRow( const float* gx, const float* gy, uchar* dst, int width );
+
+    /**
+     * Generate the slope of a line given the first two directional components
+     *
+     * @param gx line of horizontal components
+     * @param gy line of vertical components
+     * @param dst output line of slopes
+     * @param width number of pixels of a line
+     */
+    static void slopeRow( const float* gx, const float* gy, float* dst, int width );
+
+    /**
+     * Non-maximum suppression of a line of the module (pixels [1,width-2])
+     * - SSE version if available, neighbors are selected with masks (no branch)
+     *
+     * @param gx line of horizontal components of the gradient
+     * @param gy line of vertical components of the gradient
+     * @param above previous line of the module
+     * @param line current line of the module
+     * @param below next line of the module
+     * @param dst output line
+     * @param width number of pixels of a line
+     * @param interpolate flag telling whether or not to interpolate neighbors
+     */
+    static void nonMaximumSuppressionRow( const float* gx, const float* gy, const float* above, const float* line, const float* below, float* dst, int width, bool interpolate );
+
+    /**
+     * Append the non null data of a line to a list of edge pixels (stream compaction)
+     * - SSE version if available, groups of 4 null data are skipped with a single test
+     *
+     * @param src input line
+     * @param direction line of direction codes (cNullDirection if NULL)
+     * @param x index of the line
+     * @param width number of pixels of a line
+     * @param edgePixels list of edge pixels (updated)
+     */
+    static void compactRow( const float* src, const uchar* direction, int x, int width, EdgePixels& edgePixels );
+
+    /**
+     * Classify pixels for a hysteresis threshold : strong, weak or no edge
+     * - strong edges are above the high threshold, weak edges are above the low threshold (null data are not edges)
+     *
+     * @param src input data
+     * @param highThreshold high threshold
+     * @param lowThreshold low threshold
+     * @param classes output classes (8 bits, with a border of 1 pixel of no edge, reallocated only if its size does not match)
+     */
+    static void classifyHysteresis( const cv::Mat& src, float highThreshold, float lowThreshold, cv::Mat& classes );
+
+    /**
+     * Grow strong edges through 8-connected weak edges (flood fill)
+     * - strong edges and weak edges connected to them become connected edges
+     * - each pixel is pushed at most once on an explicit stack (linear time, no recursion)
+     *
+     * @param classes classes of pixels (8 bits, with a border of 1 pixel of no edge), modified in place
+     * @param stack stack buffer (resized to the number of pixels if required, can be reused between calls)
+     */
+    static void connectHysteresis( cv::Mat& classes, std::vector< int >& stack );
+
+    /**
+     * Grow strong edges through 8-connected weak edges, with bands of lines processed in parallel
+     * - each band labels its edges independently, labels are merged across band borders (union-find),
+     *   then edges of labels connected to a strong edge become connected edges
+     * - same result as connectHysteresis()
+     *
+     * @param classes classes of pixels (8 bits, with a border of 1 pixel of no edge), modified in place
+     */
+    static void connectHysteresisParallel( cv::Mat& classes );
 	
 	/**************************************************************************
 	 ***************************** PRIVATE SECTION ****************************
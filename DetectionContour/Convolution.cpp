@@ -0,0 +1,999 @@
+/*
+ * Image processing : edge detection
+ *
+ * Authors : Pascal Guehl, Clement Picq
+ */
+
+/**
+ * @version 1.0
+ */
+
+#include "Convolution.h"
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// System
+#if defined( __x86_64__ ) || defined( __i386__ ) || defined( _M_X64 ) || defined( _M_IX86 )
+    #define CONVOLUTION_USE_X86
+    #include <immintrin.h>
+    #ifdef _MSC_VER
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#endif
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+// Instruction sets available with the compiler
+// - AVX2 intrinsics require Visual Studio 2012, AVX-512 intrinsics Visual Studio 2017
+#ifdef CONVOLUTION_USE_X86
+    #if ! defined( _MSC_VER ) || ( _MSC_VER >= 1700 )
+        #define CONVOLUTION_USE_AVX2
+    #endif
+    #if ! defined( _MSC_VER ) || ( _MSC_VER >= 1910 )
+        #define CONVOLUTION_USE_AVX512
+    #endif
+#endif
+
+// SIMD backends must not fuse multiply and add (FMA),
+// otherwise results would differ from the scalar reference implementation
+#if defined( __clang__ )
+    #pragma STDC FP_CONTRACT OFF
+#elif defined( __GNUC__ )
+    #pragma GCC optimize( "fp-contract=off" )
+#endif
+
+/**
+ * Best backend supported by the CPU
+ */
+const Convolution::Backend Convolution::_supportedBackend = Convolution::detectBackend();
+
+/**
+ * Backend currently used
+ */
+Convolution::Backend Convolution::_backend = Convolution::_supportedBackend;
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+namespace
+{
+
+/******************************************************************************
+ * Scalar backend (reference implementation)
+ ******************************************************************************/
+
+/******************************************************************************
+ * 3x3 convolution of the pixels [pBegin,pEnd[ of a line
+ ******************************************************************************/
+void filterRowScalar( const float* pRow0, const float* pRow1, const float* pRow2, const float* pKernel, float* pDst, int pBegin, int pEnd )
+{
+    const float* rows[ 3 ] = { pRow0, pRow1, pRow2 };
+
+    float value = 0.0f;
+    for ( int y = pBegin; y < pEnd; y++ )
+    {
+        value = 0.0f;
+        for ( int i = 0; i < 3; i++ )
+        {
+            for ( int j = 0; j < 3; j++ )
+            {
+                value += rows[ i ][ y + j - 1 ] * pKernel[ i * 3 + j ];
+            }
+        }
+        pDst[ y ] = value;
+    }
+}
+
+/******************************************************************************
+ * Horizontal 1D convolution of the pixels [pBegin,pEnd[ of a line
+ ******************************************************************************/
+void filterRowHorizontalScalar( const float* pSrc, const float* pKernel, float* pDst, int pBegin, int pEnd )
+{
+    for ( int y = pBegin; y < pEnd; y++ )
+    {
+        pDst[ y ] = pSrc[ y - 1 ] * pKernel[ 0 ] + pSrc[ y ] * pKernel[ 1 ] + pSrc[ y + 1 ] * pKernel[ 2 ];
+    }
+}
+
+/******************************************************************************
+ * Vertical 1D convolution of the pixels [pBegin,pEnd[ of a line
+ ******************************************************************************/
+void filterRowVerticalScalar( const float* pRow0, const float* pRow1, const float* pRow2, const float* pKernel, float* pDst, int pBegin, int pEnd )
+{
+    for ( int y = pBegin; y < pEnd; y++ )
+    {
+        pDst[ y ] = pRow0[ y ] * pKernel[ 0 ] + pRow1[ y ] * pKernel[ 1 ] + pRow2[ y ] * pKernel[ 2 ];
+    }
+}
+
+/******************************************************************************
+ * Difference of two lines on the pixels [pBegin,pEnd[
+ ******************************************************************************/
+void subtractRowsScalar( const float* pSrc0, const float* pSrc1, float* pDst, int pBegin, int pEnd )
+{
+    for ( int y = pBegin; y < pEnd; y++ )
+    {
+        pDst[ y ] = pSrc0[ y ] - pSrc1[ y ];
+    }
+}
+
+/******************************************************************************
+ * Sum of two lines on the pixels [pBegin,pEnd[
+ ******************************************************************************/
+void addRowsScalar( const float* pSrc0, const float* pSrc1, float* pDst, int pBegin, int pEnd )
+{
+    for ( int y = pBegin; y < pEnd; y++ )
+    {
+        pDst[ y ] = pSrc0[ y ] + pSrc1[ y ];
+    }
+}
+
+/******************************************************************************
+ * Line scaled by a coefficient on the pixels [pBegin,pEnd[
+ ******************************************************************************/
+void scaleRowScalar( const float* pSrc, float pCoefficient, float* pDst, int pBegin, int pEnd )
+{
+    for ( int y = pBegin; y < pEnd; y++ )
+    {
+        pDst[ y ] = pSrc[ y ] * pCoefficient;
+    }
+}
+
+/******************************************************************************
+ * Line scaled by a coefficient and accumulated on the pixels [pBegin,pEnd[
+ ******************************************************************************/
+void accumulateRowScalar( const float* pSrc, float pCoefficient, float* pDst, int pBegin, int pEnd )
+{
+    for ( int y = pBegin; y < pEnd; y++ )
+    {
+        pDst[ y ] += pSrc[ y ] * pCoefficient;
+    }
+}
+
+#ifdef CONVOLUTION_USE_X86
+
+/******************************************************************************
+ * SSE4.1 backend : 4 output pixels per iteration
+ ******************************************************************************/
+
+#if defined( __clang__ )
+    #pragma clang attribute push( __attribute__( ( target( "sse4.1" ) ) ), apply_to = function )
+#elif defined( __GNUC__ )
+    #pragma GCC push_options
+    #pragma GCC target( "sse4.1" )
+#endif
+
+int filterRowSSE41( const float* pRow0, const float* pRow1, const float* pRow2, const float* pKernel, float* pDst, int pWidth )
+{
+    const float* rows[ 3 ] = { pRow0, pRow1, pRow2 };
+    __m128 kernel[ 9 ];
+    for ( int k = 0; k < 9; k++ )
+    {
+        kernel[ k ] = _mm_set1_ps( pKernel[ k ] );
+    }
+
+    int y = 1;
+    for ( ; y + 4 <= pWidth - 1; y += 4 )
+    {
+        __m128 value = _mm_setzero_ps();
+        for ( int i = 0; i < 3; i++ )
+        {
+            for ( int j = 0; j < 3; j++ )
+            {
+                value = _mm_add_ps( value, _mm_mul_ps( _mm_loadu_ps( rows[ i ] + y + j - 1 ), kernel[ i * 3 + j ] ) );
+            }
+        }
+        _mm_storeu_ps( pDst + y, value );
+    }
+
+    return y;
+}
+
+int filterRowHorizontalSSE41( const float* pSrc, const float* pKernel, float* pDst, int pWidth )
+{
+    const __m128 k0 = _mm_set1_ps( pKernel[ 0 ] );
+    const __m128 k1 = _mm_set1_ps( pKernel[ 1 ] );
+    const __m128 k2 = _mm_set1_ps( pKernel[ 2 ] );
+
+    int y = 1;
+    for ( ; y + 4 <= pWidth - 1; y += 4 )
+    {
+        __m128 value = _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( pSrc + y - 1 ), k0 ), _mm_mul_ps( _mm_loadu_ps( pSrc + y ), k1 ) );
+        value = _mm_add_ps( value, _mm_mul_ps( _mm_loadu_ps( pSrc + y + 1 ), k2 ) );
+        _mm_storeu_ps( pDst + y, value );
+    }
+
+    return y;
+}
+
+int filterRowVerticalSSE41( const float* pRow0, const float* pRow1, const float* pRow2, const float* pKernel, float* pDst, int pWidth )
+{
+    const __m128 k0 = _mm_set1_ps( pKernel[ 0 ] );
+    const __m128 k1 = _mm_set1_ps( pKernel[ 1 ] );
+    const __m128 k2 = _mm_set1_ps( pKernel[ 2 ] );
+
+    int y = 1;
+    for ( ; y + 4 <= pWidth - 1; y += 4 )
+    {
+        __m128 value = _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( pRow0 + y ), k0 ), _mm_mul_ps( _mm_loadu_ps( pRow1 + y ), k1 ) );
+        value = _mm_add_ps( value, _mm_mul_ps( _mm_loadu_ps( pRow2 + y ), k2 ) );
+        _mm_storeu_ps( pDst + y, value );
+    }
+
+    return y;
+}
+
+int subtractRowsSSE41( const float* pSrc0, const float* pSrc1, float* pDst, int pWidth )
+{
+    int y = 0;
+    for ( ; y + 4 <= pWidth; y += 4 )
+    {
+        _mm_storeu_ps( pDst + y, _mm_sub_ps( _mm_loadu_ps( pSrc0 + y ), _mm_loadu_ps( pSrc1 + y ) ) );
+    }
+
+    return y;
+}
+
+int addRowsSSE41( const float* pSrc0, const float* pSrc1, float* pDst, int pWidth )
+{
+    int y = 0;
+    for ( ; y + 4 <= pWidth; y += 4 )
+    {
+        _mm_storeu_ps( pDst + y, _mm_add_ps( _mm_loadu_ps( pSrc0 + y ), _mm_loadu_ps( pSrc1 + y ) ) );
+    }
+
+    return y;
+}
+
+int scaleRowSSE41( const float* pSrc, float pCoefficient, float* pDst, int pWidth )
+{
+    const __m128 coefficient = _mm_set1_ps( pCoefficient );
+
+    int y = 0;
+    for ( ; y + 4 <= pWidth; y += 4 )
+    {
+        _mm_storeu_ps( pDst + y, _mm_mul_ps( _mm_loadu_ps( pSrc + y ), coefficient ) );
+    }
+
+    return y;
+}
+
+int accumulateRowSSE41( const float* pSrc, float pCoefficient, float* pDst, int pWidth )
+{
+    const __m128 coefficient = _mm_set1_ps( pCoefficient );
+
+    int y = 0;
+    for ( ; y + 4 <= pWidth; y += 4 )
+    {
+        _mm_storeu_ps( pDst + y, _mm_add_ps( _mm_loadu_ps( pDst + y ), _mm_mul_ps( _mm_loadu_ps( pSrc + y ), coefficient ) ) );
+    }
+
+    return y;
+}
+
+#if defined( __clang__ )
+    #pragma clang attribute pop
+#elif defined( __GNUC__ )
+    #pragma GCC pop_options
+#endif
+
+#endif // CONVOLUTION_USE_X86
+
+#ifdef CONVOLUTION_USE_AVX2
+
+/******************************************************************************
+ * AVX2 backend : 8 output pixels per iteration
+ ******************************************************************************/
+
+#if defined( __clang__ )
+    #pragma clang attribute push( __attribute__( ( target( "avx2" ) ) ), apply_to = function )
+#elif defined( __GNUC__ )
+    #pragma GCC push_options
+    #pragma GCC target( "avx2" )
+#endif
+
+int filterRowAVX2( const float* pRow0, const float* pRow1, const float* pRow2, const float* pKernel, float* pDst, int pWidth )
+{
+    const float* rows[ 3 ] = { pRow0, pRow1, pRow2 };
+    __m256 kernel[ 9 ];
+    for ( int k = 0; k < 9; k++ )
+    {
+        kernel[ k ] = _mm256_set1_ps( pKernel[ k ] );
+    }
+
+    int y = 1;
+    for ( ; y + 8 <= pWidth - 1; y += 8 )
+    {
+        __m256 value = _mm256_setzero_ps();
+        for ( int i = 0; i < 3; i++ )
+        {
+            for ( int j = 0; j < 3; j++ )
+            {
+                value = _mm256_add_ps( value, _mm256_mul_ps( _mm256_loadu_ps( rows[ i ] + y + j - 1 ), kernel[ i * 3 + j ] ) );
+            }
+        }
+        _mm256_storeu_ps( pDst + y, value );
+    }
+
+    return y;
+}
+
+int filterRowHorizontalAVX2( const float* pSrc, const float* pKernel, float* pDst, int pWidth )
+{
+    const __m256 k0 = _mm256_set1_ps( pKernel[ 0 ] );
+    const __m256 k1 = _mm256_set1_ps( pKernel[ 1 ] );
+    const __m256 k2 = _mm256_set1_ps( pKernel[ 2 ] );
+
+    int y = 1;
+    for ( ; y + 8 <= pWidth - 1; y += 8 )
+    {
+        __m256 value = _mm256_add_ps( _mm256_mul_ps( _mm256_loadu_ps( pSrc + y - 1 ), k0 ), _mm256_mul_ps( _mm256_loadu_ps( pSrc + y ), k1 ) );
+        value = _mm256_add_ps( value, _mm256_mul_ps( _mm256_loadu_ps( pSrc + y + 1 ), k2 ) );
+        _mm256_storeu_ps( pDst + y, value );
+    }
+
+    return y;
+}
+
+int filterRowVerticalAVX2( const float* pRow0, const float* pRow1, const float* pRow2, const float* pKernel, float* pDst, int pWidth )
+{
+    const __m256 k0 = _mm256_set1_ps( pKernel[ 0 ] );
+    const __m256 k1 = _mm256_set1_ps( pKernel[ 1 ] );
+    const __m256 k2 = _mm256_set1_ps( pKernel[ 2 ] );
+
+    int y = 1;
+    for ( ; y + 8 <= pWidth - 1; y += 8 )
+    {
+        __m256 value = _mm256_add_ps( _mm256_mul_ps( _mm256_loadu_ps( pRow0 + y ), k0 ), _mm256_mul_ps( _mm256_loadu_ps( pRow1 + y ), k1 ) );
+        value = _mm256_add_ps( value, _mm256_mul_ps( _mm256_loadu_ps( pRow2 + y ), k2 ) );
+        _mm256_storeu_ps( pDst + y, value );
+    }
+
+    return y;
+}
+
+int subtractRowsAVX2( const float* pSrc0, const float* pSrc1, float* pDst, int pWidth )
+{
+    int y = 0;
+    for ( ; y + 8 <= pWidth; y += 8 )
+    {
+        _mm256_storeu_ps( pDst + y, _mm256_sub_ps( _mm256_loadu_ps( pSrc0 + y ), _mm256_loadu_ps( pSrc1 + y ) ) );
+    }
+
+    return y;
+}
+
+int addRowsAVX2( const float* pSrc0, const float* pSrc1, float* pDst, int pWidth )
+{
+    int y = 0;
+    for ( ; y + 8 <= pWidth; y += 8 )
+    {
+        _mm256_storeu_ps( pDst + y, _mm256_add_ps( _mm256_loadu_ps( pSrc0 + y ), _mm256_loadu_ps( pSrc1 + y ) ) );
+    }
+
+    return y;
+}
+
+int scaleRowAVX2( const float* pSrc, float pCoefficient, float* pDst, int pWidth )
+{
+    const __m256 coefficient = _mm256_set1_ps( pCoefficient );
+
+    int y = 0;
+    for ( ; y + 8 <= pWidth; y += 8 )
+    {
+        _mm256_storeu_ps( pDst + y, _mm256_mul_ps( _mm256_loadu_ps( pSrc + y ), coefficient ) );
+    }
+
+    return y;
+}
+
+int accumulateRowAVX2( const float* pSrc, float pCoefficient, float* pDst, int pWidth )
+{
+    const __m256 coefficient = _mm256_set1_ps( pCoefficient );
+
+    int y = 0;
+    for ( ; y + 8 <= pWidth; y += 8 )
+    {
+        _mm256_storeu_ps( pDst + y, _mm256_add_ps( _mm256_loadu_ps( pDst + y ), _mm256_mul_ps( _mm256_loadu_ps( pSrc + y ), coefficient ) ) );
+    }
+
+    return y;
+}
+
+#if defined( __clang__ )
+    #pragma clang attribute pop
+#elif defined( __GNUC__ )
+    #pragma GCC pop_options
+#endif
+
+#endif // CONVOLUTION_USE_AVX2
+
+#ifdef CONVOLUTION_USE_AVX512
+
+/******************************************************************************
+ * AVX-512 backend : 16 output pixels per iteration
+ ******************************************************************************/
+
+#if defined( __clang__ )
+    #pragma clang attribute push( __attribute__( ( target( "avx512f" ) ) ), apply_to = function )
+#elif defined( __GNUC__ )
+    #pragma GCC push_options
+    #pragma GCC target( "avx512f" )
+#endif
+
+int filterRowAVX512( const float* pRow0, const float* pRow1, const float* pRow2, const float* pKernel, float* pDst, int pWidth )
+{
+    const float* rows[ 3 ] = { pRow0, pRow1, pRow2 };
+    __m512 kernel[ 9 ];
+    for ( int k = 0; k < 9; k++ )
+    {
+        kernel[ k ] = _mm512_set1_ps( pKernel[ k ] );
+    }
+
+    int y = 1;
+    for ( ; y + 16 <= pWidth - 1; y += 16 )
+    {
+        __m512 value = _mm512_setzero_ps();
+        for ( int i = 0; i < 3; i++ )
+        {
+            for ( int j = 0; j < 3; j++ )
+            {
+                value = _mm512_add_ps( value, _mm512_mul_ps( _mm512_loadu_ps( rows[ i ] + y + j - 1 ), kernel[ i * 3 + j ] ) );
+            }
+        }
+        _mm512_storeu_ps( pDst + y, value );
+    }
+
+    return y;
+}
+
+int filterRowHorizontalAVX512( const float* pSrc, const float* pKernel, float* pDst, int pWidth )
+{
+    const __m512 k0 = _mm512_set1_ps( pKernel[ 0 ] );
+    const __m512 k1 = _mm512_set1_ps( pKernel[ 1 ] );
+    const __m512 k2 = _mm512_set1_ps( pKernel[ 2 ] );
+
+    int y = 1;
+    for ( ; y + 16 <= pWidth - 1; y += 16 )
+    {
+        __m512 value = _mm512_add_ps( _mm512_mul_ps( _mm512_loadu_ps( pSrc + y - 1 ), k0 ), _mm512_mul_ps( _mm512_loadu_ps( pSrc + y ), k1 ) );
+        value = _mm512_add_ps( value, _mm512_mul_ps( _mm512_loadu_ps( pSrc + y + 1 ), k2 ) );
+        _mm512_storeu_ps( pDst + y, value );
+    }
+
+    return y;
+}
+
+int filterRowVerticalAVX512( const float* pRow0, const float* pRow1, const float* pRow2, const float* pKernel, float* pDst, int pWidth )
+{
+    const __m512 k0 = _mm512_set1_ps( pKernel[ 0 ] );
+    const __m512 k1 = _mm512_set1_ps( pKernel[ 1 ] );
+    const __m512 k2 = _mm512_set1_ps( pKernel[ 2 ] );
+
+    int y = 1;
+    for ( ; y + 16 <= pWidth - 1; y += 16 )
+    {
+        __m512 value = _mm512_add_ps( _mm512_mul_ps( _mm512_loadu_ps( pRow0 + y ), k0 ), _mm512_mul_ps( _mm512_loadu_ps( pRow1 + y ), k1 ) );
+        value = _mm512_add_ps( value, _mm512_mul_ps( _mm512_loadu_ps( pRow2 + y ), k2 ) );
+        _mm512_storeu_ps( pDst + y, value );
+    }
+
+    return y;
+}
+
+int subtractRowsAVX512( const float* pSrc0, const float* pSrc1, float* pDst, int pWidth )
+{
+    int y = 0;
+    for ( ; y + 16 <= pWidth; y += 16 )
+    {
+        _mm512_storeu_ps( pDst + y, _mm512_sub_ps( _mm512_loadu_ps( pSrc0 + y ), _mm512_loadu_ps( pSrc1 + y ) ) );
+    }
+
+    return y;
+}
+
+int addRowsAVX512( const float* pSrc0, const float* pSrc1, float* pDst, int pWidth )
+{
+    int y = 0;
+    for ( ; y + 16 <= pWidth; y += 16 )
+    {
+        _mm512_storeu_ps( pDst + y, _mm512_add_ps( _mm512_loadu_ps( pSrc0 + y ), _mm512_loadu_ps( pSrc1 + y ) ) );
+    }
+
+    return y;
+}
+
+int scaleRowAVX512( const float* pSrc, float pCoefficient, float* pDst, int pWidth )
+{
+    const __m512 coefficient = _mm512_set1_ps( pCoefficient );
+
+    int y = 0;
+    for ( ; y + 16 <= pWidth; y += 16 )
+    {
+        _mm512_storeu_ps( pDst + y, _mm512_mul_ps( _mm512_loadu_ps( pSrc + y ), coefficient ) );
+    }
+
+    return y;
+}
+
+int accumulateRowAVX512( const float* pSrc, float pCoefficient, float* pDst, int pWidth )
+{
+    const __m512 coefficient = _mm512_set1_ps( pCoefficient );
+
+    int y = 0;
+    for ( ; y + 16 <= pWidth; y += 16 )
+    {
+        _mm512_storeu_ps( pDst + y, _mm512_add_ps( _mm512_loadu_ps( pDst + y ), _mm512_mul_ps( _mm512_loadu_ps( pSrc + y ), coefficient ) ) );
+    }
+
+    return y;
+}
+
+#if defined( __clang__ )
+    #pragma clang attribute pop
+#elif defined( __GNUC__ )
+    #pragma GCC pop_options
+#endif
+
+#endif // CONVOLUTION_USE_AVX512
+
+#ifdef CONVOLUTION_USE_X86
+
+/******************************************************************************
+ * cpuid instruction
+ ******************************************************************************/
+void cpuid( unsigned int pLeaf, unsigned int pSubLeaf, unsigned int* pRegisters )
+{
+#ifdef _MSC_VER
+    int registers[ 4 ];
+    __cpuidex( registers, static_cast< int >( pLeaf ), static_cast< int >( pSubLeaf ) );
+    for ( int i = 0; i < 4; i++ )
+    {
+        pRegisters[ i ] = static_cast< unsigned int >( registers[ i ] );
+    }
+#else
+    __cpuid_count( pLeaf, pSubLeaf, pRegisters[ 0 ], pRegisters[ 1 ], pRegisters[ 2 ], pRegisters[ 3 ] );
+#endif
+}
+
+/******************************************************************************
+ * xgetbv instruction : register states saved by the operating system
+ ******************************************************************************/
+unsigned long long xgetbv()
+{
+#ifdef _MSC_VER
+    return _xgetbv( 0 );
+#else
+    unsigned int eax = 0;
+    unsigned int edx = 0;
+    __asm__ __volatile__( "xgetbv" : "=a"( eax ), "=d"( edx ) : "c"( 0 ) );
+    return ( static_cast< unsigned long long >( edx ) << 32 ) | eax;
+#endif
+}
+
+#endif // CONVOLUTION_USE_X86
+
+}
+
+/******************************************************************************
+ * Detect the best backend supported by the CPU (cpuid)
+ *
+ * @return the best backend supported by the CPU
+ ******************************************************************************/
+Convolution::Backend Convolution::detectBackend()
+{
+    Backend backend = eScalarBackend;
+
+#ifdef CONVOLUTION_USE_X86
+    // Registers : eax, ebx, ecx, edx
+    unsigned int registers[ 4 ] = { 0, 0, 0, 0 };
+    cpuid( 0, 0, registers );
+    const unsigned int maxLeaf = registers[ 0 ];
+    if ( maxLeaf < 1 )
+    {
+        return backend;
+    }
+
+    // SSE4.1
+    cpuid( 1, 0, registers );
+    const bool hasSSE41 = ( registers[ 2 ] & ( 1u << 19 ) ) != 0;
+    const bool hasOSXSAVE = ( registers[ 2 ] & ( 1u << 27 ) ) != 0;
+    if ( hasSSE41 )
+    {
+        backend = eSSE41Backend;
+    }
+
+    // AVX registers must be saved by the operating system
+    const unsigned long long xcr0 = hasOSXSAVE ? xgetbv() : 0;
+    const bool hasAVXState = ( xcr0 & 0x06 ) == 0x06;
+    const bool hasAVX512State = ( xcr0 & 0xE6 ) == 0xE6;
+    if ( maxLeaf < 7 || ! hasAVXState )
+    {
+        return backend;
+    }
+
+    // AVX2 and AVX-512
+    cpuid( 7, 0, registers );
+#ifdef CONVOLUTION_USE_AVX2
+    if ( ( registers[ 1 ] & ( 1u << 5 ) ) != 0 )
+    {
+        backend = eAVX2Backend;
+    }
+#endif
+#ifdef CONVOLUTION_USE_AVX512
+    if ( ( registers[ 1 ] & ( 1u << 16 ) ) != 0 && hasAVX512State )
+    {
+        backend = eAVX512Backend;
+    }
+#endif
+#endif
+
+    return backend;
+}
+
+/******************************************************************************
+ * Get the backend currently used
+ *
+ * @return the backend currently used
+ ******************************************************************************/
+Convolution::Backend Convolution::getBackend()
+{
+    return _backend;
+}
+
+/******************************************************************************
+ * Set the backend to use
+ * - NOTE : the backend is limited to the best one supported by the CPU
+ *
+ * @param pValue the backend to use (eScalarBackend forces the reference implementation)
+ ******************************************************************************/
+void Convolution::setBackend( Backend pValue )
+{
+    _backend = ( pValue < _supportedBackend ) ? pValue : _supportedBackend;
+}
+
+/******************************************************************************
+ * Get the best backend supported by the CPU
+ *
+ * @return the best backend supported by the CPU
+ ******************************************************************************/
+Convolution::Backend Convolution::getSupportedBackend()
+{
+    return _supportedBackend;
+}
+
+/******************************************************************************
+ * Get the name of a backend
+ *
+ * @param pValue the backend
+ *
+ * @return the name of the backend
+ ******************************************************************************/
+const char* Convolution::getBackendName( Backend pValue )
+{
+    switch ( pValue )
+    {
+        case eScalarBackend:
+            return "scalar";
+
+        case eSSE41Backend:
+            return "SSE4.1";
+
+        case eAVX2Backend:
+            return "AVX2";
+
+        case eAVX512Backend:
+            return "AVX-512";
+
+        default:
+            break;
+    }
+
+    return "unknown";
+}
+
+/******************************************************************************
+ * 3x3 convolution of a line
+ *
+ * @param pRow0 previous input line
+ * @param pRow1 current input line
+ * @param pRow2 next input line
+ * @param pKernel kernel (9 values, row-major)
+ * @param pDst output line
+ * @param pWidth number of pixels of a line
+ ******************************************************************************/
+void Convolution::filterRow( const float* pRow0, const float* pRow1, const float* pRow2, const float* pKernel, float* pDst, int pWidth )
+{
+    // First pixel not handled by the SIMD backend
+    int y = 1;
+
+    switch ( _backend )
+    {
+#ifdef CONVOLUTION_USE_AVX512
+        case eAVX512Backend:
+            y = filterRowAVX512( pRow0, pRow1, pRow2, pKernel, pDst, pWidth );
+            break;
+#endif
+
+#ifdef CONVOLUTION_USE_AVX2
+        case eAVX2Backend:
+            y = filterRowAVX2( pRow0, pRow1, pRow2, pKernel, pDst, pWidth );
+            break;
+#endif
+
+#ifdef CONVOLUTION_USE_X86
+        case eSSE41Backend:
+            y = filterRowSSE41( pRow0, pRow1, pRow2, pKernel, pDst, pWidth );
+            break;
+#endif
+
+        default:
+            break;
+    }
+
+    // Remaining pixels
+    filterRowScalar( pRow0, pRow1, pRow2, pKernel, pDst, y, pWidth - 1 );
+}
+
+/******************************************************************************
+ * Horizontal 1D convolution of a line (first pass of a separable kernel)
+ *
+ * @param pSrc input line
+ * @param pKernel horizontal kernel (3 values)
+ * @param pDst output line
+ * @param pWidth number of pixels of a line
+ ******************************************************************************/
+void Convolution::filterRowHorizontal( const float* pSrc, const float* pKernel, float* pDst, int pWidth )
+{
+    // First pixel not handled by the SIMD backend
+    int y = 1;
+
+    switch ( _backend )
+    {
+#ifdef CONVOLUTION_USE_AVX512
+        case eAVX512Backend:
+            y = filterRowHorizontalAVX512( pSrc, pKernel, pDst, pWidth );
+            break;
+#endif
+
+#ifdef CONVOLUTION_USE_AVX2
+        case eAVX2Backend:
+            y = filterRowHorizontalAVX2( pSrc, pKernel, pDst, pWidth );
+            break;
+#endif
+
+#ifdef CONVOLUTION_USE_X86
+        case eSSE41Backend:
+            y = filterRowHorizontalSSE41( pSrc, pKernel, pDst, pWidth );
+            break;
+#endif
+
+        default:
+            break;
+    }
+
+    // Remaining pixels
+    filterRowHorizontalScalar( pSrc, pKernel, pDst, y, pWidth - 1 );
+}
+
+/******************************************************************************
+ * Vertical 1D convolution of a line (second pass of a separable kernel)
+ *
+ * @param pRow0 previous input line
+ * @param pRow1 current input line
+ * @param pRow2 next input line
+ * @param pKernel vertical kernel (3 values)
+ * @param pDst output line
+ * @param pWidth number of pixels of a line
+ ******************************************************************************/
+void Convolution::filterRowVertical( const float* pRow0, const float* pRow1, const float* pRow2, const float* pKernel, float* pDst, int pWidth )
+{
+    // First pixel not handled by the SIMD backend
+    int y = 1;
+
+    switch ( _backend )
+    {
+#ifdef CONVOLUTION_USE_AVX512
+        case eAVX512Backend:
+            y = filterRowVerticalAVX512( pRow0, pRow1, pRow2, pKernel, pDst, pWidth );
+            break;
+#endif
+
+#ifdef CONVOLUTION_USE_AVX2
+        case eAVX2Backend:
+            y = filterRowVerticalAVX2( pRow0, pRow1, pRow2, pKernel, pDst, pWidth );
+            break;
+#endif
+
+#ifdef CONVOLUTION_USE_X86
+        case eSSE41Backend:
+            y = filterRowVerticalSSE41( pRow0, pRow1, pRow2, pKernel, pDst, pWidth );
+            break;
+#endif
+
+        default:
+            break;
+    }
+
+    // Remaining pixels
+    filterRowVerticalScalar( pRow0, pRow1, pRow2, pKernel, pDst, y, pWidth - 1 );
+}
+
+/******************************************************************************
+ * Difference of two lines (e.g. opposite neighbors of a directional kernel)
+ *
+ * @param pSrc0 first input line
+ * @param pSrc1 second input line (subtracted)
+ * @param pDst output line
+ * @param pWidth number of pixels of a line
+ ******************************************************************************/
+void Convolution::subtractRows( const float* pSrc0, const float* pSrc1, float* pDst, int pWidth )
+{
+    // First pixel not handled by the SIMD backend
+    int y = 0;
+
+    switch ( _backend )
+    {
+#ifdef CONVOLUTION_USE_AVX512
+        case eAVX512Backend:
+            y = subtractRowsAVX512( pSrc0, pSrc1, pDst, pWidth );
+            break;
+#endif
+
+#ifdef CONVOLUTION_USE_AVX2
+        case eAVX2Backend:
+            y = subtractRowsAVX2( pSrc0, pSrc1, pDst, pWidth );
+            break;
+#endif
+
+#ifdef CONVOLUTION_USE_X86
+        case eSSE41Backend:
+            y = subtractRowsSSE41( pSrc0, pSrc1, pDst, pWidth );
+            break;
+#endif
+
+        default:
+            break;
+    }
+
+    // Remaining pixels
+    subtractRowsScalar( pSrc0, pSrc1, pDst, y, pWidth );
+}
+
+/******************************************************************************
+ * Sum of two lines (e.g. opposite neighbors of a directional kernel)
+ *
+ * @param pSrc0 first input line
+ * @param pSrc1 second input line
+ * @param pDst output line
+ * @param pWidth number of pixels of a line
+ ******************************************************************************/
+void Convolution::addRows( const float* pSrc0, const float* pSrc1, float* pDst, int pWidth )
+{
+    // First pixel not handled by the SIMD backend
+    int y = 0;
+
+    switch ( _backend )
+    {
+#ifdef CONVOLUTION_USE_AVX512
+        case eAVX512Backend:
+            y = addRowsAVX512( pSrc0, pSrc1, pDst, pWidth );
+            break;
+#endif
+
+#ifdef CONVOLUTION_USE_AVX2
+        case eAVX2Backend:
+            y = addRowsAVX2( pSrc0, pSrc1, pDst, pWidth );
+            break;
+#endif
+
+#ifdef CONVOLUTION_USE_X86
+        case eSSE41Backend:
+            y = addRowsSSE41( pSrc0, pSrc1, pDst, pWidth );
+            break;
+#endif
+
+        default:
+            break;
+    }
+
+    // Remaining pixels
+    addRowsScalar( pSrc0, pSrc1, pDst, y, pWidth );
+}
+
+/******************************************************************************
+ * Line scaled by a coefficient (first term of a linear combination of lines)
+ *
+ * @param pSrc input line
+ * @param pCoefficient coefficient
+ * @param pDst output line
+ * @param pWidth number of pixels of a line
+ ******************************************************************************/
+void Convolution::scaleRow( const float* pSrc, float pCoefficient, float* pDst, int pWidth )
+{
+    // First pixel not handled by the SIMD backend
+    int y = 0;
+
+    switch ( _backend )
+    {
+#ifdef CONVOLUTION_USE_AVX512
+        case eAVX512Backend:
+            y = scaleRowAVX512( pSrc, pCoefficient, pDst, pWidth );
+            break;
+#endif
+
+#ifdef CONVOLUTION_USE_AVX2
+        case eAVX2Backend:
+            y = scaleRowAVX2( pSrc, pCoefficient, pDst, pWidth );
+            break;
+#endif
+
+#ifdef CONVOLUTION_USE_X86
+        case eSSE41Backend:
+            y = scaleRowSSE41( pSrc, pCoefficient, pDst, pWidth );
+            break;
+#endif
+
+        default:
+            break;
+    }
+
+    // Remaining pixels
+    scaleRowScalar( pSrc, pCoefficient, pDst, y, pWidth );
+}
+
+/******************************************************************************
+ * Line scaled by a coefficient and added to the output (next terms of a linear combination of lines)
+ *
+ * @param pSrc input line
+ * @param pCoefficient coefficient
+ * @param pDst output line (updated)
+ * @param pWidth number of pixels of a line
+ ******************************************************************************/
+void Convolution::accumulateRow( const float* pSrc, float pCoefficient, float* pDst, int pWidth )
+{
+    // First pixel not handled by the SIMD backend
+    int y = 0;
+
+    switch ( _backend )
+    {
+#ifdef CONVOLUTION_USE_AVX512
+        case eAVX512Backend:
+            y = accumulateRowAVX512( pSrc, pCoefficient, pDst, pWidth );
+            break;
+#endif
+
+#ifdef CONVOLUTION_USE_AVX2
+        case eAVX2Backend:
+            y = accumulateRowAVX2( pSrc, pCoefficient, pDst, pWidth );
+            break;
+#endif
+
+#ifdef CONVOLUTION_USE_X86
+        case eSSE41Backend:
+            y = accumulateRowSSE41( pSrc, pCoefficient, pDst, pWidth );
+            break;
+#endif
+
+        default:
+            break;
+    }
+
+    // Remaining pixels
+    accumulateRowScalar( pSrc, pCoefficient, pDst, y, pWidth );
+}
@@ -0,0 +1,225 @@
+/*
+ * Image processing : edge detection
+ *
+ * Authors : Pascal Guehl, Clement Picq
+ */
+
+/**
+ * @version 1.0
+ */
+
+#ifndef CONVOLUTION_H
+#define CONVOLUTION_H
+
+/******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+ /******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ******************************** CLASS USED **********************************
+ ******************************************************************************/
+
+/******************************************************************************
+ ****************************** CLASS DEFINITION ******************************
+ ******************************************************************************/
+
+/**
+ * @class Convolution
+ *
+ * @brief The Convolution class provides the 3x3 convolution row kernels used by algorithm::filter(),
+ * and the line operations used by the single pass gradient (algorithm::DirectionalKernels).
+ *
+ * Row kernels work on CV_32F lines and write the output pixels [1,width-2] of a line.
+ * Line operations are element-wise and write all the pixels [0,width-1] of a line.
+ * The instruction set (scalar, SSE4.1, AVX2 or AVX-512) is chosen at startup with cpuid.
+ * The scalar backend is the reference implementation : SIMD backends perform
+ * the same operations in the same order, so that results are identical bit for bit.
+ */
+class Convolution
+{
+
+	/**************************************************************************
+	 ***************************** PUBLIC SECTION *****************************
+	 **************************************************************************/
+
+public:
+
+	/****************************** INNER TYPES *******************************/
+
+    /**
+     * Backend types (i.e. instruction sets)
+     */
+    enum Backend
+    {
+        eScalarBackend = 0,
+        eSSE41Backend,
+        eAVX2Backend,
+        eAVX512Backend,
+        eNbBackends
+    };
+
+    /******************************* ATTRIBUTES *******************************/
+
+	/******************************** METHODS *********************************/
+
+    /**
+     * Get the backend currently used
+     *
+     * @return the backend currently used
+     */
+    static Backend getBackend();
+
+    /**
+     * Set the backend to use
+     * - NOTE : the backend is limited to the best one supported by the CPU
+     *
+     * @param pValue the backend to use (eScalarBackend forces the reference implementation)
+     */
+    static void setBackend( Backend pValue );
+
+    /**
+     * Get the best backend supported by the CPU
+     *
+     * @return the best backend supported by the CPU
+     */
+    static Backend getSupportedBackend();
+
+    /**
+     * Get the name of a backend
+     *
+     * @param pValue the backend
+     *
+     * @return the name of the backend
+     */
+    static const char* getBackendName( Backend pValue );
+
+    /**
+     * 3x3 convolution of a line
+     *
+     * @param pRow0 previous input line
+     * @param pRow1 current input line
+     * @param pRow2 next input line
+     * @param pKernel kernel (9 values, row-major)
+     * @param pDst output line
+     * @param pWidth number of pixels of a line
+     */
+    static void filterRow( const float* pRow0, const float* pRow1, const float* pRow2, const float* pKernel, float* pDst, int pWidth );
+
+    /**
+     * Horizontal 1D convolution of a line (first pass of a separable kernel)
+     *
+     * @param pSrc input line
+     * @param pKernel horizontal kernel (3 values)
+     * @param pDst output line
+     * @param pWidth number of pixels of a line
+     */
+    static void filterRowHorizontal( const float* pSrc, const float* pKernel, float* pDst, int pWidth );
+
+    /**
+     * Vertical 1D convolution of a line (second pass of a separable kernel)
+     *
+     * @param pRow0 previous input line
+     * @param pRow1 current input line
+     * @param pRow2 next input line
+     * @param pKernel vertical kernel (3 values)
+     * @param pDst output line
+     * @param pWidth number of pixels of a line
+     */
+    static void filterRowVertical( const float* pRow0, const float* pRow1, const float* pRow2, const float* pKernel, float* pDst, int pWidth );
+
+    /**
+     * Difference of two lines (e.g. opposite neighbors of a directional kernel)
+     *
+     * @param pSrc0 first input line
+     * @param pSrc1 second input line (subtracted)
+     * @param pDst output line
+     * @param pWidth number of pixels of a line
+     */
+    static void subtractRows( const float* pSrc0, const float* pSrc1, float* pDst, int pWidth );
+
+    /**
+     * Sum of two lines (e.g. opposite neighbors of a directional kernel)
+     *
+     * @param pSrc0 first input line
+     * @param pSrc1 second input line
+     * @param pDst output line
+     * @param pWidth number of pixels of a line
+     */
+    static void addRows( const float* pSrc0, const float* pSrc1, float* pDst, int pWidth );
+
+    /**
+     * Line scaled by a coefficient (first term of a linear combination of lines)
+     *
+     * @param pSrc input line
+     * @param pCoefficient coefficient
+     * @param pDst output line
+     * @param pWidth number of pixels of a line
+     */
+    static void scaleRow( const float* pSrc, float pCoefficient, float* pDst, int pWidth );
+
+    /**
+     * Line scaled by a coefficient and added to the output (next terms of a linear combination of lines)
+     *
+     * @param pSrc input line
+     * @param pCoefficient coefficient
+     * @param pDst output line (updated)
+     * @param pWidth number of pixels of a line
+     */
+    static void accumulateRow( const float* pSrc, float pCoefficient, float* pDst, int pWidth );
+
+    /**************************************************************************
+	 **************************** PROTECTED SECTION ***************************
+	 **************************************************************************/
+
+protected:
+
+	/****************************** INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+    /**
+     * Best backend supported by the CPU
+     */
+    static const Backend _supportedBackend;
+
+    /**
+     * Backend currently used
+     */
+    static Backend _backend;
+
+	/******************************** METHODS *********************************/
+
+    /**
+     * Detect the best backend supported by the CPU (cpuid)
+     *
+     * @return the best backend supported by the CPU
+     */
+    static Backend detectBackend();
+
+	/**************************************************************************
+	 ***************************** PRIVATE SECTION ****************************
+	 **************************************************************************/
+
+private:
+
+	/****************************** INNER TYPES *******************************/
+
+	/******************************* ATTRIBUTES *******************************/
+
+    /******************************** METHODS *********************************/
+
+};
+
+/**************************************************************************
+ ***************************** INLINE SECTION *****************************
+ **************************************************************************/
+
+#endif // CONVOLUTION_H
@@ -43,7 +43,8 @@ SOURCES += main.cpp \
     PerformanceTimer.cpp \
     PerformanceTimer.inl \
     Hough.cpp \
-    Algorithm.cpp
+    Algorithm.cpp \
+    Convolution.cpp
 
 HEADERS += \
     MainWindow.h \
@@ -53,7 +54,8 @@ HEADERS += \
     Image.h \
     PerformanceTimer.h \
     Hough.h \
-    Algorithm.h
+    Algorithm.h \
+    Convolution.h
 
 FORMS += \
     MainWindow.ui
@@ -22,6 +22,12 @@
 #include <fstream>
 #include <iostream>
 
+// SSE
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+    #define HISTOGRAM_USE_SSE
+    #include <emmintrin.h>
+#endif
+
 /******************************************************************************
  ****************************** NAMESPACE SECTION *****************************
  ******************************************************************************/
@@ -37,15 +43,102 @@ using namespace std;
  ***************************** TYPE DEFINITION ********************************
  ******************************************************************************/
 
+namespace
+{
+
+/**
+ * Parallel histogram : each band of lines is accumulated by a worker thread in private bins
+ */
+class HistogramBody : public cv::ParallelLoopBody
+{
+
+public:
+
+    /**
+     * Constructor
+     *
+     * @param pHistogram histogram (used to find the bin of a value)
+     * @param pData input data
+     * @param pNbBands number of bands of lines
+     * @param pCounts private bins of each band
+     */
+    HistogramBody( const Histogram& pHistogram, const cv::Mat& pData, int pNbBands, std::vector< unsigned long >* pCounts )
+    :   _histogram( pHistogram )
+    ,   _data( pData )
+    ,   _nbBands( pNbBands )
+    ,   _counts( pCounts )
+    {
+    }
+
+    /**
+     * Accumulate a range of bands
+     *
+     * @param pRange range of bands
+     */
+    virtual void operator()( const cv::Range& pRange ) const
+    {
+        std::vector< int > bins( _data.cols );
+        for ( int band = pRange.start; band < pRange.end; band++ ) {
+            unsigned long* counts = &_counts[ band ][ 0 ];
+            const int end = static_cast< int >( static_cast< long >( _data.rows ) * ( band + 1 ) / _nbBands );
+            for ( int x = static_cast< int >( static_cast< long >( _data.rows ) * band / _nbBands ); x < end; x++ ) {
+                // Bins of the line first (vectorized), then counts
+                _histogram.getBins( _data.ptr< float >( x ), &bins[ 0 ], _data.cols );
+                for ( int y = 0; y < _data.cols; y++ ) {
+                    counts[ bins[ y ] ]++;
+                }
+            }
+        }
+    }
+
+protected:
+
+    /**
+     * Histogram
+     */
+    const Histogram& _histogram;
+
+    /**
+     * Input data
+     */
+    const cv::Mat& _data;
+
+    /**
+     * Number of bands of lines
+     */
+    int _nbBands;
+
+    /**
+     * Private bins of each band
+     */
+    std::vector< unsigned long >* _counts;
+
+};
+
+}
+
 /******************************************************************************
  ***************************** METHOD DEFINITION ******************************
  ******************************************************************************/
 
 /******************************************************************************
  * Constructor
+ *
+ * @param pNbBins number of bins
+ * @param pMin min value of the range of data
+ * @param pMax max value of the range of data (excluded)
  ******************************************************************************/
-Histogram::Histogram()
+Histogram::Histogram( int pNbBins, float pMin, float pMax )
+:   _nbBins( pNbBins )
+,   _min( pMin )
+,   _max( pMax )
+,   _scale( static_cast< float >( pNbBins ) / ( pMax - pMin ) )
+,   _counts( pNbBins, 0 )
+,   _cumulativeCounts( pNbBins, 0 )
+,   _cumulativeWeightedSums( pNbBins, 0.0 )
 {
+    assert( pNbBins > 0 );
+    assert( pMax > pMin );
 }
 
 /******************************************************************************
@@ -53,9 +146,176 @@ Histogram::Histogram()
  ******************************************************************************/
 Histogram::~Histogram()
 {
-    // TODO
-    // check openCV reference counter
-    assert( false );
+}
+
+/******************************************************************************
+ * Compute the histogram of data
+ * - bands of lines are processed in parallel
+ *
+ * @param pData input data (CV_32F)
+ ******************************************************************************/
+void Histogram::compute( const cv::Mat& pData )
+{
+    assert( pData.depth() == CV_32F && pData.channels() == 1 );
+
+    std::fill( _counts.begin(), _counts.end(), 0 );
+
+    // Accumulate bands of lines in private bins
+    if ( pData.rows > 0 )
+    {
+        const int nbBands = std::min( pData.rows, std::max( 1, cv::getNumThreads() ) );
+        std::vector< std::vector< unsigned long > > counts( nbBands, std::vector< unsigned long >( _nbBins, 0 ) );
+        cv::parallel_for_( cv::Range( 0, nbBands ), HistogramBody( *this, pData, nbBands, &counts[ 0 ] ) );
+
+        // Merge private bins
+        for ( int band = 0; band < nbBands; band++ ) {
+            for ( int i = 0; i < _nbBins; i++ ) {
+                _counts[ i ] += counts[ band ][ i ];
+            }
+        }
+    }
+
+    // Cumulative counts and weighted sums
+    unsigned long cumulativeCount = 0;
+    double cumulativeWeightedSum = 0.0;
+    for ( int i = 0; i < _nbBins; i++ ) {
+        cumulativeCount += _counts[ i ];
+        cumulativeWeightedSum += static_cast< double >( _counts[ i ] ) * getBinValue( i );
+        _cumulativeCounts[ i ] = cumulativeCount;
+        _cumulativeWeightedSums[ i ] = cumulativeWeightedSum;
+    }
+}
+
+/******************************************************************************
+ * Get the number of bins
+ *
+ * @return the number of bins
+ ******************************************************************************/
+int Histogram::getNbBins() const
+{
+    return _nbBins;
+}
+
+/******************************************************************************
+ * Get the bins of a line of values
+ * - SSE version if available, same result as getBin()
+ *
+ * @param pValues the values
+ * @param pBins the bins of the values
+ * @param pWidth the number of values
+ ******************************************************************************/
+void Histogram::getBins( const float* pValues, int* pBins, int pWidth ) const
+{
+    int y = 0;
+#ifdef HISTOGRAM_USE_SSE
+    // Clamp positions to [0,nbBins-1] before truncation
+    // - max( position, 0 ) returns 0 for NaN, as getBin()
+    const __m128 min = _mm_set1_ps( _min );
+    const __m128 scale = _mm_set1_ps( _scale );
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 lastBin = _mm_set1_ps( static_cast< float >( _nbBins - 1 ) );
+    for ( ; y <= pWidth - 4; y += 4 ) {
+        __m128 position = _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps( pValues + y ), min ), scale );
+        position = _mm_min_ps( _mm_max_ps( position, zero ), lastBin );
+        _mm_storeu_si128( reinterpret_cast< __m128i* >( pBins + y ), _mm_cvttps_epi32( position ) );
+    }
+#endif
+    for ( ; y < pWidth; y++ ) {
+        pBins[ y ] = getBin( pValues[ y ] );
+    }
+}
+
+/******************************************************************************
+ * Get the value of a bin (i.e. its lower bound)
+ *
+ * @param pBin the bin
+ *
+ * @return the value of the bin
+ ******************************************************************************/
+float Histogram::getBinValue( int pBin ) const
+{
+    return _min + static_cast< float >( pBin ) / _scale;
+}
+
+/******************************************************************************
+ * Get the number of values of a bin
+ *
+ * @param pBin the bin
+ *
+ * @return the number of values of the bin
+ ******************************************************************************/
+unsigned long Histogram::getCount( int pBin ) const
+{
+    return _counts[ pBin ];
+}
+
+/******************************************************************************
+ * Get the number of values of all bins
+ *
+ * @return the number of values of all bins
+ ******************************************************************************/
+unsigned long Histogram::getTotalCount() const
+{
+    return _cumulativeCounts.back();
+}
+
+/******************************************************************************
+ * Get the number of values of bins [0,pBin]
+ *
+ * @param pBin the last bin
+ *
+ * @return the number of values of bins [0,pBin]
+ ******************************************************************************/
+unsigned long Histogram::getCumulativeCount( int pBin ) const
+{
+    return _cumulativeCounts[ pBin ];
+}
+
+/******************************************************************************
+ * Get the weighted sum (count of a bin times its value) of all bins
+ *
+ * @return the weighted sum of all bins
+ ******************************************************************************/
+double Histogram::getTotalWeightedSum() const
+{
+    return _cumulativeWeightedSums.back();
+}
+
+/******************************************************************************
+ * Get the weighted sum (count of a bin times its value) of bins [0,pBin]
+ *
+ * @param pBin the last bin
+ *
+ * @return the weighted sum of bins [0,pBin]
+ ******************************************************************************/
+double Histogram::getCumulativeWeightedSum( int pBin ) const
+{
+    return _cumulativeWeightedSums[ pBin ];
+}
+
+/******************************************************************************
+ * Find the first bin whose cumulative count reaches a target
+ *
+ * @param pTarget the target
+ *
+ * @return the first bin whose cumulative count reaches the target (number of bins if none)
+ ******************************************************************************/
+int Histogram::findCumulativeCount( unsigned long pTarget ) const
+{
+    return static_cast< int >( std::lower_bound( _cumulativeCounts.begin(), _cumulativeCounts.end(), pTarget ) - _cumulativeCounts.begin() );
+}
+
+/******************************************************************************
+ * Find the first bin whose cumulative weighted sum reaches a target
+ * - NOTE : bin values have to be positive (i.e. cumulative weighted sums are increasing)
+ *
+ * @param pTarget the target
+ *
+ * @return the first bin whose cumulative weighted sum reaches the target (number of bins if none)
+ ******************************************************************************/
+int Histogram::findCumulativeWeightedSum( double pTarget ) const
+{
+    return static_cast< int >( std::lower_bound( _cumulativeWeightedSums.begin(), _cumulativeWeightedSums.end(), pTarget ) - _cumulativeWeightedSums.begin() );
 }
 
 /******************************************************************************
@@ -65,4 +325,7 @@ void Histogram::print()
 {
     // LOG
     cout << "HISTOGRAM info" << endl;
+    cout << "- bins: " << _nbBins << " in [" << _min << "," << _max << "[" << endl;
+    cout << "- count: " << getTotalCount() << endl;
+    cout << "- weighted sum: " << getTotalWeightedSum() << endl;
 }
@@ -51,6 +51,14 @@
  
 /**
  * @class Histogram
+ *
+ * @brief The Histogram class provides the histogram of float data (i.e. an image) used by threshold methods.
+ *
+ * Values are distributed in a given number of bins of same width over a range [min,max[
+ * (values out of range go to first or last bin).
+ * Bands of lines are processed in parallel with private bins, merged at the end.
+ * Cumulative counts and cumulative weighted sums (count of a bin times its value) are computed once,
+ * so that several thresholds can be determined from a single pass over the data.
  */
 class Histogram
 {
@@ -69,14 +77,121 @@ public:
 
 	/**
      * Constructor
+     *
+     * @param pNbBins number of bins
+     * @param pMin min value of the range of data
+     * @param pMax max value of the range of data (excluded)
 	 */
-    Histogram();
+    Histogram( int pNbBins = 256, float pMin = 0.0f, float pMax = 256.0f );
 
     /**
      * Destructor
      */
     virtual ~Histogram();
 
+    /**
+     * Compute the histogram of data
+     * - bands of lines are processed in parallel
+     *
+     * @param pData input data (CV_32F)
+     */
+    void compute( const cv::Mat& pData );
+
+    /**
+     * Get the number of bins
+     *
+     * @return the number of bins
+     */
+    int getNbBins() const;
+
+    /**
+     * Get the bin of a value
+     *
+     * @param pValue the value
+     *
+     * @return the bin of the value
+     */
+    inline int getBin( float pValue ) const;
+
+    /**
+     * Get the bins of a line of values
+     * - SSE version if available, same result as getBin()
+     *
+     * @param pValues the values
+     * @param pBins the bins of the values
+     * @param pWidth the number of values
+     */
+    void getBins( const float* pValues, int* pBins, int pWidth ) const;
+
+    /**
+     * Get the value of a bin (i.e. its lower bound)
+     *
+     * @param pBin the bin
+     *
+     * @return the value of the bin
+     */
+    float getBinValue( int pBin ) const;
+
+    /**
+     * Get the number of values of a bin
+     *
+     * @param pBin the bin
+     *
+     * @return the number of values of the bin
+     */
+    unsigned long getCount( int pBin ) const;
+
+    /**
+     * Get the number of values of all bins
+     *
+     * @return the number of values of all bins
+     */
+    unsigned long getTotalCount() const;
+
+    /**
+     * Get the number of values of bins [0,pBin]
+     *
+     * @param pBin the last bin
+     *
+     * @return the number of values of bins [0,pBin]
+     */
+    unsigned long getCumulativeCount( int pBin ) const;
+
+    /**
+     * Get the weighted sum (count of a bin times its value) of all bins
+     *
+     * @return the weighted sum of all bins
+     */
+    double getTotalWeightedSum() const;
+
+    /**
+     * Get the weighted sum (count of a bin times its value) of bins [0,pBin]
+     *
+     * @param pBin the last bin
+     *
+     * @return the weighted sum of bins [0,pBin]
+     */
+    double getCumulativeWeightedSum( int pBin ) const;
+
+    /**
+     * Find the first bin whose cumulative count reaches a target
+     *
+     * @param pTarget the target
+     *
+     * @return the first bin whose cumulative count reaches the target (number of bins if none)
+     */
+    int findCumulativeCount( unsigned long pTarget ) const;
+
+    /**
+     * Find the first bin whose cumulative weighted sum reaches a target
+     * - NOTE : bin values have to be positive (i.e. cumulative weighted sums are increasing)
+     *
+     * @param pTarget the target
+     *
+     * @return the first bin whose cumulative weighted sum reaches the target (number of bins if none)
+     */
+    int findCumulativeWeightedSum( double pTarget ) const;
+
     /**
      * Print info
      */
@@ -92,6 +207,41 @@ protected:
 
 	/******************************* ATTRIBUTES *******************************/
 
+    /**
+     * Number of bins
+     */
+    int _nbBins;
+
+    /**
+     * Min value of the range of data
+     */
+    float _min;
+
+    /**
+     * Max value of the range of data (excluded)
+     */
+    float _max;
+
+    /**
+     * Number of bins per unit of value
+     */
+    float _scale;
+
+    /**
+     * Number of values of each bin
+     */
+    std::vector< unsigned long > _counts;
+
+    /**
+     * Cumulative number of values of each bin
+     */
+    std::vector< unsigned long > _cumulativeCounts;
+
+    /**
+     * Cumulative weighted sum of each bin
+     */
+    std::vector< double > _cumulativeWeightedSums;
+
 	/******************************** METHODS *********************************/
 	
 	/**************************************************************************
@@ -112,4 +262,23 @@ private:
  ***************************** INLINE SECTION *****************************
  **************************************************************************/
 
+/******************************************************************************
+ * Get the bin of a value
+ *
+ * @param pValue the value
+ *
+ * @return the bin of the value
+ ******************************************************************************/
+inline int Histogram::getBin( float pValue ) const
+{
+    const float position = ( pValue - _min ) * _scale;
+    if ( ! ( position >= 0.0f ) ) {
+        return 0;
+    }
+    if ( position >= static_cast< float >( _nbBins ) ) {
+        return _nbBins - 1;
+    }
+    return static_cast< int >( position );
+}
+
 #endif // HISTOGRAM_H
@@ -68,9 +68,26 @@ Hough::Hough()
  * @return the number of vote for every segment
  ******************************************************************************/
 cv::Mat Hough::CreateSegmentAccumulator( const cv::Mat& image )
+{
+    // Sparse list of valid pixels
+    algorithm::EdgePixels edgePixels;
+    algorithm::extractEdgePixels( image, NULL, edgePixels );
+
+    return CreateSegmentAccumulator( edgePixels );
+}
+
+/******************************************************************************
+ * Make a vote for every segment possible
+ * - only edge pixels are visited
+ *
+ * @param edgePixels list of edge pixels of the image to analize
+ *
+ * @return the number of vote for every segment
+ ******************************************************************************/
+cv::Mat Hough::CreateSegmentAccumulator( const algorithm::EdgePixels& edgePixels )
 {
     //rho maximum size
-    const int maxRho = (int)sqrt( static_cast< float >( image.rows * image.rows + image.cols * image.cols ) );
+    const int maxRho = (int)sqrt( static_cast< float >( edgePixels._nbRows * edgePixels._nbRows + edgePixels._nbColumns * edgePixels._nbColumns ) );
 
     // Hough space parameters [rho, theta]
     // - theta range: [-pi/2, pi]
@@ -90,42 +107,33 @@ cv::Mat Hough::CreateSegmentAccumulator( const cv::Mat& image )
     // Initiaize accumulator to 0
     accumulator.setTo( 0 );
 
-    // Iterate through pixels of the input image
-    // - image lines
-    for ( int x = 0; x < image.rows; x++ )
+    // Iterate through edge pixels of the input image
+    // - valid pixel usally means "is an edge/contour"
+    for ( int p = 0; p < edgePixels.size(); p++ )
     {
-         // - image columns
-        for ( int y = 0; y < image.cols; y++ )
-        {
-            // Check validity of pixel
-            // - consider a binary image
-            // - valid pixel usally means "is an edge/contour"
-            if ( image.at< float >( x, y ) == 0.0f )
-            {
-                continue;
-            }
+        const int x = edgePixels._x[ p ];
+        const int y = edgePixels._y[ p ];
 
-            // Iterate through parameters in Hough space (i.e. [rho,theta])
-            // - initialize theta (range: [-pi/2, pi])
-            theta = -PI/2;
-            for ( int i = 0; i < nbTetha; i++ )
-            {
-                // Update theta
-                theta += deltaTheta;
+        // Iterate through parameters in Hough space (i.e. [rho,theta])
+        // - initialize theta (range: [-pi/2, pi])
+        theta = -PI/2;
+        for ( int i = 0; i < nbTetha; i++ )
+        {
+            // Update theta
+            theta += deltaTheta;
 
-                // Compute rho
-                rho = (int)( ( ( x * cos( theta ) + y * sin( theta ) ) / (float)deltaRho ) + 0.5f );
+            // Compute rho
+            rho = (int)( ( ( x * cos( theta ) + y * sin( theta ) ) / (float)deltaRho ) + 0.5f );
 
-                // Check validity of "rho" parameter
-                if ( rho > 0.0f )
+            // Check validity of "rho" parameter
+            if ( rho > 0.0f )
+            {
+                if ( accumulator.at< uchar >( i, rho ) < 255 )
                 {
-                    if ( accumulator.at< uchar >( i, rho ) < 255 )
-                    {
-                        // Update accumulatore by voting
-                        accumulator.at< uchar >( i/*theta*/, rho ) += 1;
+                    // Update accumulatore by voting
+                    accumulator.at< uchar >( i/*theta*/, rho ) += 1;
 
-                        //std::cout << "create " << theta*(180 /PI) <<" "<< rho << std::endl;
-                    }
+                    //std::cout << "create " << theta*(180 /PI) <<" "<< rho << std::endl;
                 }
             }
         }
@@ -349,6 +357,25 @@ int Hough::segmentThreshold(cv::Mat& accu, int nbLines )
  * @return the Hough accumulator for circle detection
  ******************************************************************************/
 cv::Mat Hough::generateCircleAccumulator( const cv::Mat& pImage, float pRadius )
+{
+    // Sparse list of valid pixels
+    algorithm::EdgePixels edgePixels;
+    algorithm::extractEdgePixels( pImage, NULL, edgePixels );
+
+    return generateCircleAccumulator( edgePixels, pRadius );
+}
+
+/******************************************************************************
+ * Generate the Hough accumulator for circle detection,
+ * given a user defined radius
+ * - only edge pixels are visited
+ *
+ * @param pEdgePixels list of edge pixels of the input image
+ * @param pRadius circle radius
+ *
+ * @return the Hough accumulator for circle detection
+ ******************************************************************************/
+cv::Mat Hough::generateCircleAccumulator( const algorithm::EdgePixels& pEdgePixels, float pRadius )
 {
      //printf( "\nINSIDE generateCircleAccumulator() - FIXED radius" );
 
@@ -360,8 +387,8 @@ cv::Mat Hough::generateCircleAccumulator( const cv::Mat& pImage, float pRadius )
     //float b = 0.0f;
     //const float deltaA = 0.0f;
     //const float deltaB = 0.0f;
-    const int nbA = pImage.cols;
-    const int nbB = pImage.rows;
+    const int nbA = pEdgePixels._nbColumns;
+    const int nbB = pEdgePixels._nbRows;
 
     //printf( "\ncreate accumulator()" );
 
@@ -371,51 +398,47 @@ cv::Mat Hough::generateCircleAccumulator( const cv::Mat& pImage, float pRadius )
     //  - initiaize accumulator to 0
     cv::Mat accumulator = cv::Mat( nbB, nbA, CV_8U/*uchar type*/, cv::Scalar( 0 ) );
 
-    // Iterate through pixels of the input image
+    // Iterate through edge pixels of the input image
     int A = 0;
-     // - image lines
-    for ( int x = 0; x < pImage.rows; x++ )
+    for ( int p = 0; p < pEdgePixels.size(); p++ )
     {
-         // - image columns
-        for ( int y = 0; y < pImage.cols; y++ )
+        // Check validity of pixel
+        // - valid pixel usally means "is an edge/contour"
+        if ( pEdgePixels._modules[ p ] < cEPSILLON )
         {
-            // Check validity of pixel
-            // - consider a binary image
-            // - valid pixel usally means "is an edge/contour"
-            if ( pImage.at< float >( x, y ) < cEPSILLON )
-            {
-                continue;
-            }
+            continue;
+        }
+        const int x = pEdgePixels._x[ p ];
+        const int y = pEdgePixels._y[ p ];
 
-            // Iterate through parameters in Hough space (i.e. [a,b] and r fixed)
-            for ( int i = 0; i < nbB; i++ )
+        // Iterate through parameters in Hough space (i.e. [a,b] and r fixed)
+        for ( int i = 0; i < nbB; i++ )
+        {
+            // (x-a)*(x-a)+(y-b)*(y-b)=r*r
+            const float tmp = r*r - (y-i)*(y-i);
+            if ( tmp >= 0.0f )
             {
-                // (x-a)*(x-a)+(y-b)*(y-b)=r*r
-                const float tmp = r*r - (y-i)*(y-i);
-                if ( tmp >= 0.0f )
-                {
-                    a = x - sqrtf( tmp );
+                a = x - sqrtf( tmp );
 
-                    // Check validity of "a" parameter
-                    if ( a > 0.0f )
+                // Check validity of "a" parameter
+                if ( a > 0.0f )
+                {
+                    A = static_cast< int >( a + 0.5f );
+                    assert( A < nbA );
+                      if ( accumulator.at< uchar >( i/*b*/, A ) < 255 )
                     {
-                        A = static_cast< int >( a + 0.5f );
-                        assert( A < nbA );
-                          if ( accumulator.at< uchar >( i/*b*/, A ) < 255 )
-                        {
-                            // Update accumulatore by voting
-                            accumulator.at< uchar >( i/*b*/, A ) += 1;
-                        }
+                        // Update accumulatore by voting
+                        accumulator.at< uchar >( i/*b*/, A ) += 1;
                     }
                 }
+            }
 #if 0
-                else
-                {
-                    // LOG
-      //              printf( "\n(A,B) = (%f,%f)", a, b );
-                }
-#endif
+            else
+            {
+                // LOG
+  //              printf( "\n(A,B) = (%f,%f)", a, b );
             }
+#endif
         }
     }
 
@@ -453,6 +476,23 @@ cv::Mat Hough::generateCircleAccumulator( const cv::Mat& pImage, float pRadius )
  * @return the Hough accumulator for circle detection
  ******************************************************************************/
 cv::Mat Hough::generateCircleAccumulator( const cv::Mat& pImage )
+{
+    // Sparse list of valid pixels
+    algorithm::EdgePixels edgePixels;
+    algorithm::extractEdgePixels( pImage, NULL, edgePixels );
+
+    return generateCircleAccumulator( edgePixels );
+}
+
+/******************************************************************************
+ * Generate the Hough accumulator for circle detection
+ * - only edge pixels are visited
+ *
+ * @param pEdgePixels list of edge pixels of the input image
+ *
+ * @return the Hough accumulator for circle detection
+ ******************************************************************************/
+cv::Mat Hough::generateCircleAccumulator( const algorithm::EdgePixels& pEdgePixels )
 {
    // printf( "\nINSIDE generateCircleAccumulator() - NON-FIXED radius" );
 
@@ -462,12 +502,12 @@ cv::Mat Hough::generateCircleAccumulator( const cv::Mat& pImage )
     //float b = 0.0f;
     //const float deltaA = 0.0f;
     //const float deltaB = 0.0f;
-    const int nbA = pImage.cols;
-    const int nbB = pImage.rows;
+    const int nbA = pEdgePixels._nbColumns;
+    const int nbB = pEdgePixels._nbRows;
     // - radius r: [0,...]
     //float r = 0.0f;
     //const float deltaR = 0.0f;
-    const int nbR = max( pImage.rows, pImage.cols );
+    const int nbR = max( pEdgePixels._nbRows, pEdgePixels._nbColumns );
 
     //printf( "\ncreate accumulator()" );
 
@@ -478,53 +518,49 @@ cv::Mat Hough::generateCircleAccumulator( const cv::Mat& pImage )
     int accumulatorSizes[] = { nbB, nbA, nbR };
     cv::Mat accumulator = cv::Mat( 3, accumulatorSizes, CV_8U/*uchar type*/, cv::Scalar( 0 ) );
 
-    // Iterate through pixels of the input image
+    // Iterate through edge pixels of the input image
     int A = 0;
-    // - image lines
-    for ( int x = 0; x < pImage.rows; x++ )
+    for ( int p = 0; p < pEdgePixels.size(); p++ )
     {
-         // - image columns
-        for ( int y = 0; y < pImage.cols; y++ )
+        // Check validity of pixel
+        // - valid pixel usally means "is an edge/contour"
+        if ( pEdgePixels._modules[ p ] < cEPSILLON )
         {
-            // Check validity of pixel
-            // - consider a binary image
-            // - valid pixel usally means "is an edge/contour"
-            if ( pImage.at< float >( x, y ) < cEPSILLON )
-            {
-                continue;
-            }
+            continue;
+        }
+        const int x = pEdgePixels._x[ p ];
+        const int y = pEdgePixels._y[ p ];
 
-            // Iterate through parameters in Hough space (i.e. [a,b,r])
-            for ( int k = 0; k < nbR; k++ )
+        // Iterate through parameters in Hough space (i.e. [a,b,r])
+        for ( int k = 0; k < nbR; k++ )
+        {
+            for ( int i = 0; i < nbB; i++ )
             {
-                for ( int i = 0; i < nbB; i++ )
+                // (x-a)*(x-a)+(y-b)*(y-b)=r*r
+                const float tmp = static_cast< float >( k*k - (y-i)*(y-i) );
+                if ( tmp >= 0.0f )
                 {
-                    // (x-a)*(x-a)+(y-b)*(y-b)=r*r
-                    const float tmp = static_cast< float >( k*k - (y-i)*(y-i) );
-                    if ( tmp >= 0.0f )
-                    {
-                        a = x - sqrtf( tmp );
+                    a = x - sqrtf( tmp );
 
-                        // Check validity of "a" parameter
-                        if ( a > 0.0f )
+                    // Check validity of "a" parameter
+                    if ( a > 0.0f )
+                    {
+                        A = static_cast< int >( a + 0.5f );
+                        assert( A < nbA );
+                        if ( accumulator.at< uchar >( i/*b*/, A, k/*r*/ ) < 255 )
                         {
-                            A = static_cast< int >( a + 0.5f );
-                            assert( A < nbA );
-                            if ( accumulator.at< uchar >( i/*b*/, A, k/*r*/ ) < 255 )
-                            {
-                                // Update accumulatore by voting
-                                accumulator.at< uchar >( i/*b*/, A, k/*r*/ ) += 1;
-                            }
+                            // Update accumulatore by voting
+                            accumulator.at< uchar >( i/*b*/, A, k/*r*/ ) += 1;
                         }
                     }
+                }
 #if 0
-                    else
-                    {
-                        // LOG
-                //        printf( "\n(A,B,R) = (%f,%f,%f)", a, b, r );
-                    }
-#endif
+                else
+                {
+                    // LOG
+            //        printf( "\n(A,B,R) = (%f,%f,%f)", a, b, r );
                 }
+#endif
             }
         }
     }
@@ -29,6 +29,9 @@
 // STL
 #include <vector>
 
+// Project
+#include "Algorithm.h"
+
 /******************************************************************************
  ************************* DEFINE AND CONSTANT SECTION ************************
  ******************************************************************************/
@@ -78,6 +81,16 @@ public:
      */
     cv::Mat CreateSegmentAccumulator( const cv::Mat& image );
 
+    /**
+     * make a vote for every segment possible
+     * - only edge pixels are visited
+     *
+     * @param edgePixels list of edge pixels of the image to analize
+     *
+     * @return the number of vote for every segment
+     */
+    cv::Mat CreateSegmentAccumulator( const algorithm::EdgePixels& edgePixels );
+
     /**
      * return a matrice with all the segment that are declared valide
      *
@@ -119,6 +132,18 @@ public:
      */
     cv::Mat generateCircleAccumulator( const cv::Mat& pImage, float pRadius );
 
+    /**
+     * Generate the Hough accumulator for circle detection,
+     * given a user defined radius
+     * - only edge pixels are visited
+     *
+     * @param pEdgePixels list of edge pixels of the input image
+     * @param pRadius circle radius
+     *
+     * @return the Hough accumulator for circle detection
+     */
+    cv::Mat generateCircleAccumulator( const algorithm::EdgePixels& pEdgePixels, float pRadius );
+
     /**
      * Generate the Hough accumulator for circle detection
      *
@@ -128,6 +153,16 @@ public:
      */
     cv::Mat generateCircleAccumulator( const cv::Mat& pImage );
 
+    /**
+     * Generate the Hough accumulator for circle detection
+     * - only edge pixels are visited
+     *
+     * @param pEdgePixels list of edge pixels of the input image
+     *
+     * @return the Hough accumulator for circle detection
+     */
+    cv::Mat generateCircleAccumulator( const algorithm::EdgePixels& pEdgePixels );
+
     /**
      * Extract circles from the Hough accumulator,
      * based on most significant values (votes)
@@ -216,6 +216,17 @@ void MainWindow::on__hysteresisLowThresholdSpinBox_valueChanged( int i )
     }
 }
 
+/******************************************************************************
+ *
+ ******************************************************************************/
+void MainWindow::on__userDefinedThresholdSpinBox_valueChanged( int i )
+{
+    if ( _pipeline != NULL )
+    {
+        _pipeline->setUserDefinedThresholdValue( i );
+    }
+}
+
 /******************************************************************************
  *
  ******************************************************************************/
@@ -246,7 +257,7 @@ void MainWindow::on__edgeMethodComboBox_currentIndexChanged( int pIndex )
 {
     if ( _pipeline != NULL )
     {
-    //    _pipeline->setUseEdgeClosure( static_cast< Pipeline::EdgeClosureType >( pIndex ) );
+        _pipeline->setEdgeClosureType( static_cast< Pipeline::EdgeClosureType >( pIndex ) );
     }
 }
 
@@ -41,6 +41,7 @@ public slots:
     void on__localThresholdSpinBox_valueChanged( int i );
     void on__hysteresisHighThresholdSpinBox_valueChanged( int i );
     void on__hysteresisLowThresholdSpinBox_valueChanged( int i );
+    void on__userDefinedThresholdSpinBox_valueChanged( int i );
 
     // Edges
     void on__edgeGroupBox_toggled( bool pOn );
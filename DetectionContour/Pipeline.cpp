@@ -79,22 +79,36 @@ Pipeline::Pipeline()
 ,   _visualizeImage( true )
 ,   _visualizeGradient( false )
 ,   _normType( eLInfinity )
+,   _useFastL2Norm( false )
 ,   _useEdgeExtraction( false )
 ,   _useEdgeClosure( false )
+,   _usePolygonalApproximation( false )
+,   _polygonalApproximationTolerance( 1.0f )
 ,   _visualizeEdges( false )
 ,   _useThreshold( false )
 ,   _useLocalExtrema( false )
+,   _useInterpolatedLocalExtrema( false )
+,   _useIsolatedPointsSuppression( false )
+,   _isolatedPointsRingSize( 1 )
 ,   _visualizeThreshold( false )
 ,   _useGradient( false )
 ,   _globalThresholdValidPixelPercentage( 60 )
-,   _globalThresholdValue( 0 )
+,   _globalThresholdValue( 0.0f )
 ,   _localThresholdWindowSize( 15 )
 ,   _hysteresisThresholdHighValidPixelPercentage( 50 )
 ,   _hysteresisThresholdLowValidPixelPercentage( 75 )
-,   _hysteresisThresholdHighValue( 0 )
-,   _hysteresisThresholdLowValue( 0 )
+,   _userDefinedThresholdValue( 80 )
+,   _thresholdHistogramNbBins( 4096 )
+,   _hysteresisThresholdHighValue( 0.0f )
+,   _hysteresisThresholdLowValue( 0.0f )
+,   _useParallelHysteresis( false )
+,   _useParallelEdgeExtraction( false )
+,   _edgeMinLength( 0 )
+,   _edgeMinContrast( 0.0f )
 ,   _useBinaryDisplay( false )
+,   _edgeClosureType( eGradientEdgeClosure )
 ,   _edgeClosureNbIterations( 5 )
+,   _edgeClosureMaxDistance( 5 )
 ,   _useHoughSegmentDetection( false )
 ,   _useHoughCircleDetection( false )
 ,   _houghSegmentCriteria( 2 )
@@ -166,17 +180,21 @@ bool Pipeline::execute()
     PerformanceTimer::Event processEvent = timer.createEvent();
     PerformanceTimer::Event gradientEvent = timer.createEvent();
     PerformanceTimer::Event thresholdEvent = timer.createEvent();
+    PerformanceTimer::Event isolatedPointsEvent = timer.createEvent();
     PerformanceTimer::Event localExtremaEvent = timer.createEvent();
     PerformanceTimer::Event edgeExtractionEvent = timer.createEvent();
     PerformanceTimer::Event edgeClosureEvent = timer.createEvent();
+    PerformanceTimer::Event polygonalApproximationEvent = timer.createEvent();
     PerformanceTimer::Event houghSegmentDetectionEvent = timer.createEvent();
     PerformanceTimer::Event houghCircleDetectionEvent = timer.createEvent();
     float processTime = 0.0f;
     float gradientTime = 0.0f;
     float thresholdTime = 0.0f;
+    float isolatedPointsTime = 0.0f;
     float localExtremaTime = 0.0f;
     float edgeExtractionTime = 0.0f;
     float edgeClosureTime = 0.0f;
+    float polygonalApproximationTime = 0.0f;
     float houghSegmentDetectionTime = 0.0f;
     float houghCircleDetectionTime = 0.0f;
 
@@ -207,53 +225,33 @@ bool Pipeline::execute()
     // Gradient
     if ( _useGradient )
     {
-        // Compute directional components of gradient
-        //  - apply dedicated kernels
+        // Compute gradient : module and direction
+        //  - apply dedicated kernels (all directions in a single pass)
+        //  - directional components are only stored for visualization (all of them) and local extrema (X and Y only)
         char title[] = "Gradient GX";
-        for ( int i = 0; i < NbDirection; i++ )
+        int nbGradients = 0;
+        if ( _visualizeGradient )
         {
-            title[ 10 ] = i + '0';
-
-            timer.startEvent( gradientEvent );
-            _gradient[ i ] = algorithm::filter( image, _kernelDirection[ i ] );
-            timer.stopEvent( gradientEvent );
-            gradientTime += timer.getEventDuration( gradientEvent );
-
-            //algorithm::displayMat( title, gradient[ i ], false );
+            nbGradients = NbDirection;
         }
-        // Gradient visualization
-        if ( _visualizeGradient )
+        else if ( _useThreshold && _useLocalExtrema )
         {
-            for ( int i = 0; i < NbDirection; i++ )
-            {
-                // Need to normalize to [0,255] before visualization
-                //algorithm::normalize( gradient[ i ] );  // BEWARE : normalize modify gradient !!!!!!!!!!
-                title[ 10 ] = i + '0';
-                //algorithm::displayMat( title, gradient[ i ], false );
-
-                timer.startEvent( gradientEvent );
-                cv::Mat tmp = algorithm::normalizeData( _gradient[ i ] );
-                timer.stopEvent( gradientEvent );
-                gradientTime += timer.getEventDuration( gradientEvent );
-
-                // Visualization
-                algorithm::displayMat( title, tmp, false );
-            }
+            nbGradients = 2;
         }
-
-        // Retrieve gradient : module and slope
+        for ( int i = nbGradients; i < 4; i++ )
+        {
+            _gradient[ i ].release();
+        }
+        cv::Mat* gradient = ( nbGradients > 0 ) ? _gradient : NULL;
         switch ( _normType )
         {
             case eLInfinity:
                 {
                     // L-infinity norm
                     timer.startEvent( gradientEvent );
-                    _module = algorithm::moduleLinf( _gradient, NbDirection );
+                    algorithm::gradientModule( image, _kernelDirection, NbDirection, algorithm::eLInfinity, _module, _direction, NULL, gradient, nbGradients );
                     timer.stopEvent( gradientEvent );
                     gradientTime += timer.getEventDuration( gradientEvent );
-
-                    // Visualization
-                    algorithm::displayMat( "Gradient - module (L-infinity norm)", _module, false );
                 }
                 break;
 
@@ -261,32 +259,78 @@ bool Pipeline::execute()
                 {
                     // L1 norm
                     timer.startEvent( gradientEvent );
-                    _module = algorithm::moduleL1( _gradient, NbDirection );
+                    algorithm::gradientModule( image, _kernelDirection, NbDirection, algorithm::eL1, _module, _direction, NULL, gradient, nbGradients );
                     timer.stopEvent( gradientEvent );
                     gradientTime += timer.getEventDuration( gradientEvent );
+                }
+                break;
 
-                    // Visualization
-                    algorithm::displayMat( "Gradient - module (L1 norm)", _module, false );
+            case eL2:
+                {
+                    // L2 norm
+                    algorithm::_useFastL2Norm = _useFastL2Norm;
+                    timer.startEvent( gradientEvent );
+                    algorithm::gradientModule( image, _kernelDirection, NbDirection, algorithm::eL2, _module, _direction, NULL, gradient, nbGradients );
+                    timer.stopEvent( gradientEvent );
+                    gradientTime += timer.getEventDuration( gradientEvent );
                 }
                 break;
 
             default:
-                // TODO : L2 norm
                 assert( false );
                 break;
         }
 
+        // Gradient visualization
+        if ( _visualizeGradient )
+        {
+            for ( int i = 0; i < NbDirection; i++ )
+            {
+                // Need to normalize to [0,255] before visualization (done during conversion to keep gradient unchanged)
+                title[ 10 ] = i + '0';
+                algorithm::displayNormalizedMat( title, _gradient[ i ] );
+            }
+        }
+
+        // Module visualization
+        switch ( _normType )
+        {
+            case eL1:
+                algorithm::displayMat( "Gradient - module (L1 norm)", _module, false );
+                break;
+
+            case eL2:
+                algorithm::displayMat( "Gradient - module (L2 norm)", _module, false );
+                break;
+
+            default:
+                algorithm::displayMat( "Gradient - module (L-infinity norm)", _module, false );
+                break;
+        }
+
         // Threshold
         if ( _useThreshold )
         {
             // LOG
             cout << "\nApply THRESHOLD" << endl;
 
+            // Histogram resolution of histogram based methods
+            algorithm::_histogramNbBins = _thresholdHistogramNbBins;
+
             switch ( _thresholdType )
             {
                 case eUserDefinedThreshold:
-                    //const int threshold = 80;
-                    //moduleThreshold = algorithm::threshold( module, threshold );
+                    {
+                        // LOG
+                        cout << "- User defined method" << endl;
+                        cout << "- threshold value : " << _userDefinedThresholdValue << endl;
+
+                        // Apply threshold (the output buffer is reused between executions)
+                        timer.startEvent( thresholdEvent );
+                        algorithm::applyThreshold( _module, _userDefinedThresholdValue, _moduleThreshold );
+                        timer.stopEvent( thresholdEvent );
+                        thresholdTime += timer.getEventDuration( thresholdEvent );
+                    }
                     break;
 
                 case eGlobalThreshold:
@@ -307,7 +351,7 @@ bool Pipeline::execute()
 
                         // Apply threshold
                         timer.startEvent( thresholdEvent );
-                        _moduleThreshold = algorithm::applyThreshold( _module, _globalThresholdValue );
+                        algorithm::applyThreshold( _module, _globalThresholdValue, _moduleThreshold );
                         timer.stopEvent( thresholdEvent );
                         thresholdTime += timer.getEventDuration( thresholdEvent );
                     }
@@ -335,8 +379,54 @@ bool Pipeline::execute()
 
                         algorithm::_highThresholdPercent = static_cast< float >(_hysteresisThresholdHighValidPixelPercentage );
                         algorithm::_lowThresholdPercent = static_cast< float >( _hysteresisThresholdLowValidPixelPercentage );
+                        algorithm::_useParallelHysteresis = _useParallelHysteresis;
+                        timer.startEvent( thresholdEvent );
+                        _moduleThreshold = algorithm::hysteresis( _module, _hysteresisThresholdHighValue, _hysteresisThresholdLowValue, _hysteresisClasses, _hysteresisStack );
+                        timer.stopEvent( thresholdEvent );
+                        thresholdTime += timer.getEventDuration( thresholdEvent );
+                    }
+                    break;
+
+                case eOtsuThreshold:
+                    {
+                        // LOG
+                        cout << "- Otsu method (histogram)" << endl;
+
+                        timer.startEvent( thresholdEvent );
+                        _globalThresholdValue = algorithm::otsuThreshold( _module );
+                        algorithm::applyThreshold( _module, _globalThresholdValue, _moduleThreshold );
+                        timer.stopEvent( thresholdEvent );
+                        thresholdTime += timer.getEventDuration( thresholdEvent );
+
+                        // LOG
+                        cout << "- determined threshold value : " << _globalThresholdValue << endl;
+                    }
+                    break;
+
+                case eEntropyThreshold:
+                    {
+                        // LOG
+                        cout << "- Kapur entropy method (histogram)" << endl;
+
+                        timer.startEvent( thresholdEvent );
+                        _globalThresholdValue = algorithm::entropyThreshold( _module );
+                        algorithm::applyThreshold( _module, _globalThresholdValue, _moduleThreshold );
+                        timer.stopEvent( thresholdEvent );
+                        thresholdTime += timer.getEventDuration( thresholdEvent );
+
+                        // LOG
+                        cout << "- determined threshold value : " << _globalThresholdValue << endl;
+                    }
+                    break;
+
+                case eOtsuHysteresisThreshold:
+                    {
+                        // LOG
+                        cout << "- Hysteris method (Otsu)" << endl;
+
+                        algorithm::_useParallelHysteresis = _useParallelHysteresis;
                         timer.startEvent( thresholdEvent );
-                        _moduleThreshold = algorithm::hysteresis( _module, _hysteresisThresholdHighValue, _hysteresisThresholdLowValue );
+                        _moduleThreshold = algorithm::otsuHysteresis( _module, _hysteresisThresholdHighValue, _hysteresisThresholdLowValue, _hysteresisClasses, _hysteresisStack );
                         timer.stopEvent( thresholdEvent );
                         thresholdTime += timer.getEventDuration( thresholdEvent );
                     }
@@ -351,14 +441,33 @@ bool Pipeline::execute()
             // Visualization
             algorithm::displayMat( "Gradient - Threshold (module)", _moduleThreshold , _useBinaryDisplay );
 
-            // Gradient slope
+            // Suppress isolated points
+            if ( _useIsolatedPointsSuppression )
+            {
+                // LOG
+                cout << "\nApply ISOLATED POINTS SUPPRESSION" << endl;
+                cout << "- ring size: " << _isolatedPointsRingSize << endl;
+
+                timer.startEvent( isolatedPointsEvent );
+                algorithm::supprIsoletedPoints( _moduleThreshold, _isolatedPointsRingSize, _moduleIsolatedPoints );
+                timer.stopEvent( isolatedPointsEvent );
+                isolatedPointsTime += timer.getEventDuration( isolatedPointsEvent );
+
+                // Next stages use the filtered module (both buffers are reused between executions)
+                std::swap( _moduleThreshold, _moduleIsolatedPoints );
+
+                // Visualization
+                algorithm::displayMat( "Isolated Points Suppression", _moduleThreshold , _useBinaryDisplay );
+            }
+
+            // Gradient direction
             timer.startEvent( gradientEvent );
-            _pente = algorithm::pente( _gradient, NbDirection, _moduleThreshold );
+            algorithm::maskDirection( _direction, _moduleThreshold );
             timer.stopEvent( gradientEvent );
             gradientTime += timer.getEventDuration( gradientEvent );
             // Gradient slope visualization
             timer.startEvent( gradientEvent );
-            _penteColor = algorithm::colorMat( _pente, _moduleThreshold );
+            _penteColor = algorithm::colorMat( _direction, _moduleThreshold );
             timer.stopEvent( gradientEvent );
             gradientTime += timer.getEventDuration( gradientEvent );
             algorithm::displayMat( "Gradient - Slope", _penteColor, false );
@@ -370,7 +479,7 @@ bool Pipeline::execute()
                 cout << "\nApply LOCAL EXTREMA" << endl;
 
                 timer.startEvent( localExtremaEvent );
-                _localExtrema = algorithm::localExtremum( _pente, _moduleThreshold );
+                algorithm::nonMaximumSuppression( _gradient[ 0 ], _gradient[ 1 ], _moduleThreshold, _localExtrema, _useInterpolatedLocalExtrema, &_edgePixels );
                 timer.stopEvent( localExtremaEvent );
                 localExtremaTime += timer.getEventDuration( localExtremaEvent );
 
@@ -385,7 +494,7 @@ bool Pipeline::execute()
 
                     timer.startEvent( houghSegmentDetectionEvent );
 
-                    cv::Mat accumulator = hough->CreateSegmentAccumulator( _localExtrema );
+                    cv::Mat accumulator = hough->CreateSegmentAccumulator( _edgePixels );
                     int segmentCriteria = _houghSegmentCriteria;
                     segmentCriteria = hough->segmentThreshold( accumulator, 30 );
                     cv::Mat affiche = hough->getSegmentFromAccumulator( accumulator, _localExtrema.rows, _localExtrema.cols, segmentCriteria/*nbMinPoints*/);
@@ -427,7 +536,7 @@ bool Pipeline::execute()
                     cv::Mat accumulator;
                     if ( _useHoughCircleFixedRadius )
                     {
-                         accumulator = hough->generateCircleAccumulator( _localExtrema, circleRadius );
+                         accumulator = hough->generateCircleAccumulator( _edgePixels, circleRadius );
 
                          // LOG
                          printf( "\t - fixed radius: %f", circleRadius );
@@ -437,7 +546,7 @@ bool Pipeline::execute()
                         // LOG
                         printf( "\t - NON-fixed radius: %f", circleRadius );
 
-                        accumulator = hough->generateCircleAccumulator( _localExtrema );
+                        accumulator = hough->generateCircleAccumulator( _edgePixels );
                     }
                     // Visualization
                     if ( _useBinaryDisplay )
@@ -481,20 +590,29 @@ bool Pipeline::execute()
                 cout << "\nApply EDGE EXTRACTION" << endl;
 
                 // Extract edges
+                algorithm::_useParallelEdgeExtraction = _useParallelEdgeExtraction;
+                algorithm::_edgeMinLength = _edgeMinLength;
+                algorithm::_edgeMinContrast = _edgeMinContrast;
                 timer.startEvent( edgeExtractionEvent );
-                std::vector< algorithm::Edge > listEdges = algorithm::freemanEncoding( _localExtrema );
+                algorithm::freemanEncoding( _localExtrema, _edgePixels, _listEdges );
                 timer.stopEvent( edgeExtractionEvent );
                 edgeExtractionTime += timer.getEventDuration( edgeExtractionEvent );
 
                 // LOG
-                cout << "- extracted edges: " << listEdges.size() << endl;
+                cout << "- extracted edges: " << _listEdges.size() << endl;
+                int nbClosedEdges = 0;
+                for ( int i = 0; i < _listEdges.size(); i++ )
+                {
+                    nbClosedEdges += _listEdges._edges[ i ]._isClosed ? 1 : 0;
+                }
+                cout << "- closed edges: " << nbClosedEdges << endl;
 
                 // Visualization
                 //if ( _visualizeEdges )
                 //{
                     // Close edges/contours
                     timer.startEvent( edgeExtractionEvent );
-                    _edges = algorithm::traceEdges( listEdges, image.rows, image.cols );
+                    _edges = algorithm::traceEdges( _listEdges, image.rows, image.cols );
                     timer.stopEvent( edgeExtractionEvent );
                     edgeExtractionTime += timer.getEventDuration( edgeExtractionEvent );
 
@@ -508,28 +626,58 @@ bool Pipeline::execute()
                     cout << "\nApply EDGE CLOSURE" << endl;
 
                     // Close contours
-                    algorithm::edgesClosure(listEdges, _localExtrema, _pente, _edgeClosureNbIterations );
+                    timer.startEvent( edgeClosureEvent );
+                    if ( _edgeClosureType == eEndpointEdgeClosure )
+                    {
+                        algorithm::edgesClosureByEndpoints( _listEdges, image.rows, image.cols, _edgeClosureMaxDistance );
+                    }
+                    else
+                    {
+                        algorithm::edgesClosure(_listEdges, _localExtrema, _direction, _edgeClosureNbIterations );
+                    }
 
                     // Close edges/contours
-                    timer.startEvent( edgeClosureEvent );
-                    _edges = algorithm::traceEdges( listEdges, image.rows, image.cols );
+                    _edges = algorithm::traceEdges( _listEdges, image.rows, image.cols );
                     timer.stopEvent( edgeClosureEvent );
                     edgeClosureTime += timer.getEventDuration( edgeClosureEvent );
 
                     // Visualize
                     cv::imshow( "Closed Edges", _edges );
                 }
+
+                // Polygonal approximation of edges
+                if ( _usePolygonalApproximation )
+                {
+                    // LOG
+                    cout << "\nApply POLYGONAL APPROXIMATION" << endl;
+                    cout << "- tolerance: " << _polygonalApproximationTolerance << endl;
+
+                    timer.startEvent( polygonalApproximationEvent );
+                    algorithm::polygonalApproximation( _listEdges, _polygonalApproximationTolerance, _polylines );
+                    timer.stopEvent( polygonalApproximationEvent );
+                    polygonalApproximationTime += timer.getEventDuration( polygonalApproximationEvent );
+
+                    // LOG
+                    cout << "- vertices: " << _polylines._x.size() << endl;
+
+                    // Visualize
+                    cv::Mat polygons = cv::Mat( image.rows, image.cols, CV_8U, cv::Scalar( 0 ) );
+                    for ( int i = 0; i < _polylines.size(); i++ )
+                    {
+                        for ( int v = _polylines._firstVertices[ i ]; v < _polylines._firstVertices[ i + 1 ] - 1; v++ )
+                        {
+                            cv::line( polygons, cv::Point( _polylines._y[ v ], _polylines._x[ v ] ), cv::Point( _polylines._y[ v + 1 ], _polylines._x[ v + 1 ] ), cv::Scalar( 255 ), 1, 8, 0 );
+                        }
+                    }
+                    cv::imshow( "Polygonal Approximation", polygons );
+                }
             }
         }
         else
         {
-            timer.startEvent( gradientEvent );
-            _pente = algorithm::pente( _gradient, NbDirection, _module );
-            timer.stopEvent( gradientEvent );
-            gradientTime += timer.getEventDuration( gradientEvent );
             // Gradient slope visualization
             timer.startEvent( gradientEvent );
-            _penteColor = algorithm::colorMat( _pente, _module );
+            _penteColor = algorithm::colorMat( _direction, _module );
             timer.stopEvent( gradientEvent );
             gradientTime += timer.getEventDuration( gradientEvent );
             algorithm::displayMat( "Gradient - Slope", _penteColor, false);
@@ -543,9 +691,11 @@ bool Pipeline::execute()
     cout << "\nPIPELINE process time: " << processTime << " ms" << endl;
     cout << "- gradient             : " << gradientTime << " ms" << " - " << ( ( gradientTime / processTime ) * 100.0f ) << " %" << endl;
     cout << "- threshold            : " << thresholdTime << " ms" << " - " << ( ( thresholdTime / processTime ) * 100.0f ) << " %" << endl;
+    cout << "- isolated points      : " << isolatedPointsTime << " ms" << " - " << ( ( isolatedPointsTime / processTime ) * 100.0f ) << " %" << endl;
     cout << "- local extrema        : " << localExtremaTime << " ms" << " - " << ( ( localExtremaTime / processTime ) * 100.0f ) << " %" << endl;
     cout << "- edge extraction      : " << edgeExtractionTime << " ms" << " - " << ( ( edgeExtractionTime / processTime ) * 100.0f ) << " %" << endl;
     cout << "- edge closure         : " << edgeClosureTime << " ms" << " - " << ( ( edgeClosureTime / processTime ) * 100.0f ) << " %" << endl;
+    cout << "- polygonal approx.    : " << polygonalApproximationTime << " ms" << " - " << ( ( polygonalApproximationTime / processTime ) * 100.0f ) << " %" << endl;
     cout << "- Hough (segment)      : " << houghSegmentDetectionTime << " ms" << " - " << ( ( houghSegmentDetectionTime / processTime ) * 100.0f ) << " %" << endl;
     cout << "- Hough (circle)       : " << houghCircleDetectionTime << " ms" << " - " << ( ( houghCircleDetectionTime / processTime ) * 100.0f ) << " %" << endl;
 
@@ -705,7 +855,8 @@ bool Pipeline::finalizeFilters()
     }
     _module.~Mat();
     _moduleThreshold.~Mat();
-    _pente.~Mat();
+    _moduleIsolatedPoints.~Mat();
+    _direction.~Mat();
     _penteColor.~Mat();
     _localExtrema.~Mat();
     _edges.~Mat();
@@ -799,6 +950,22 @@ void Pipeline::setNormType( NormType pValue )
     _normType = pValue;
 }
 
+/******************************************************************************
+ *
+ ******************************************************************************/
+bool Pipeline::useFastL2Norm() const
+{
+    return _useFastL2Norm;
+}
+
+/******************************************************************************
+ *
+ ******************************************************************************/
+void Pipeline::setUseFastL2Norm( bool pFlag )
+{
+    _useFastL2Norm = pFlag;
+}
+
 /******************************************************************************
  *
  ******************************************************************************/
@@ -877,6 +1044,52 @@ void Pipeline::setUseLocalExtrema( bool pFlag )
     _useLocalExtrema = pFlag;
 }
 
+/******************************************************************************
+ *
+ ******************************************************************************/
+bool Pipeline::useInterpolatedLocalExtrema() const
+{
+    return _useInterpolatedLocalExtrema;
+}
+
+/******************************************************************************
+ *
+ ******************************************************************************/
+void Pipeline::setUseInterpolatedLocalExtrema( bool pFlag )
+{
+    _useInterpolatedLocalExtrema = pFlag;
+}
+
+/******************************************************************************
+ * Set the flag telling whether or not to suppress isolated points after threshold
+ *
+ * @param pFlag a flag telling whether or not to suppress isolated points after threshold
+ ******************************************************************************/
+void Pipeline::setUseIsolatedPointsSuppression( bool pFlag )
+{
+    _useIsolatedPointsSuppression = pFlag;
+}
+
+/******************************************************************************
+ * Get the size of the ring neighborhood used to suppress isolated points
+ *
+ * @return the size of the ring neighborhood used to suppress isolated points
+ ******************************************************************************/
+int Pipeline::getIsolatedPointsRingSize() const
+{
+    return _isolatedPointsRingSize;
+}
+
+/******************************************************************************
+ * Set the size of the ring neighborhood used to suppress isolated points
+ *
+ * @param pValue the size of the ring neighborhood used to suppress isolated points
+ ******************************************************************************/
+void Pipeline::setIsolatedPointsRingSize( int pValue )
+{
+    _isolatedPointsRingSize = pValue;
+}
+
 /******************************************************************************
  * Set the flag telling whether or not to use gradient
  *
@@ -897,6 +1110,54 @@ void Pipeline::setUseEdgeClosure( bool pFlag )
     _useEdgeClosure = pFlag;
 }
 
+/******************************************************************************
+ *
+ ******************************************************************************/
+Pipeline::EdgeClosureType Pipeline::getEdgeClosureType() const
+{
+    return _edgeClosureType;
+}
+
+/******************************************************************************
+ *
+ ******************************************************************************/
+void Pipeline::setEdgeClosureType( EdgeClosureType pValue )
+{
+    _edgeClosureType = pValue;
+}
+
+/******************************************************************************
+ *
+ ******************************************************************************/
+void Pipeline::setUsePolygonalApproximation( bool pFlag )
+{
+    _usePolygonalApproximation = pFlag;
+}
+
+/******************************************************************************
+ *
+ ******************************************************************************/
+float Pipeline::getPolygonalApproximationTolerance() const
+{
+    return _polygonalApproximationTolerance;
+}
+
+/******************************************************************************
+ *
+ ******************************************************************************/
+void Pipeline::setPolygonalApproximationTolerance( float pValue )
+{
+    _polygonalApproximationTolerance = pValue;
+}
+
+/******************************************************************************
+ *
+ ******************************************************************************/
+const algorithm::Polylines& Pipeline::getPolylines() const
+{
+    return _polylines;
+}
+
 /******************************************************************************
  *
  ******************************************************************************/
@@ -916,7 +1177,7 @@ void Pipeline::setGlobalThresholdValidPixelPercentage( int pValue )
 /******************************************************************************
  *
  ******************************************************************************/
-int Pipeline::getGlobalThresholdValue() const
+float Pipeline::getGlobalThresholdValue() const
 {
     return _globalThresholdValue;
 }
@@ -937,6 +1198,38 @@ void Pipeline::setLocalThresholdWindowSize( int pValue )
     _localThresholdWindowSize = pValue;
 }
 
+/******************************************************************************
+ *
+ ******************************************************************************/
+int Pipeline::getUserDefinedThresholdValue() const
+{
+    return _userDefinedThresholdValue;
+}
+
+/******************************************************************************
+ *
+ ******************************************************************************/
+void Pipeline::setUserDefinedThresholdValue( int pValue )
+{
+    _userDefinedThresholdValue = pValue;
+}
+
+/******************************************************************************
+ *
+ ******************************************************************************/
+int Pipeline::getThresholdHistogramNbBins() const
+{
+    return _thresholdHistogramNbBins;
+}
+
+/******************************************************************************
+ *
+ ******************************************************************************/
+void Pipeline::setThresholdHistogramNbBins( int pValue )
+{
+    _thresholdHistogramNbBins = pValue;
+}
+
 /******************************************************************************
  *
  ******************************************************************************/
@@ -956,7 +1249,7 @@ void Pipeline::setHysteresisThresholdHighValidPixelPercentage( int pValue )
 /******************************************************************************
  *
  ******************************************************************************/
-int Pipeline::getHysteresisThresholdHighValue() const
+float Pipeline::getHysteresisThresholdHighValue() const
 {
     return _hysteresisThresholdHighValue;
 }
@@ -980,11 +1273,83 @@ void Pipeline::setHysteresisThresholdLowValidPixelPercentage( int pValue )
 /******************************************************************************
  *
  ******************************************************************************/
-int Pipeline::getHysteresisThresholdLowValue() const
+float Pipeline::getHysteresisThresholdLowValue() const
 {
     return _hysteresisThresholdLowValue;
 }
 
+/******************************************************************************
+ *
+ ******************************************************************************/
+bool Pipeline::useParallelHysteresis() const
+{
+    return _useParallelHysteresis;
+}
+
+/******************************************************************************
+ *
+ ******************************************************************************/
+void Pipeline::setUseParallelHysteresis( bool pFlag )
+{
+    _useParallelHysteresis = pFlag;
+}
+
+/******************************************************************************
+ *
+ ******************************************************************************/
+bool Pipeline::useParallelEdgeExtraction() const
+{
+    return _useParallelEdgeExtraction;
+}
+
+/******************************************************************************
+ *
+ ******************************************************************************/
+void Pipeline::setUseParallelEdgeExtraction( bool pFlag )
+{
+    _useParallelEdgeExtraction = pFlag;
+}
+
+/******************************************************************************
+ *
+ ******************************************************************************/
+int Pipeline::getEdgeMinLength() const
+{
+    return _edgeMinLength;
+}
+
+/******************************************************************************
+ *
+ ******************************************************************************/
+void Pipeline::setEdgeMinLength( int pValue )
+{
+    _edgeMinLength = pValue;
+}
+
+/******************************************************************************
+ *
+ ******************************************************************************/
+float Pipeline::getEdgeMinContrast() const
+{
+    return _edgeMinContrast;
+}
+
+/******************************************************************************
+ *
+ ******************************************************************************/
+void Pipeline::setEdgeMinContrast( float pValue )
+{
+    _edgeMinContrast = pValue;
+}
+
+/******************************************************************************
+ *
+ ******************************************************************************/
+const algorithm::EdgeList& Pipeline::getEdges() const
+{
+    return _listEdges;
+}
+
 /******************************************************************************
  * Get the flag to tell whether or not to display images in binary mode
  *
@@ -1025,6 +1390,26 @@ void Pipeline::setEdgeClosureNbIterations( unsigned int pValue )
     _edgeClosureNbIterations = pValue;
 }
 
+/******************************************************************************
+ * Get the max gap (in pixels) between linked ends when edges are linked by their ends
+ *
+ * @return the max gap between linked ends
+ ******************************************************************************/
+unsigned int Pipeline::getEdgeClosureMaxDistance() const
+{
+    return _edgeClosureMaxDistance;
+}
+
+/******************************************************************************
+ * Set the max gap (in pixels) between linked ends when edges are linked by their ends
+ *
+ * @param pValue the max gap between linked ends
+ ******************************************************************************/
+void Pipeline::setEdgeClosureMaxDistance( unsigned int pValue )
+{
+    _edgeClosureMaxDistance = pValue;
+}
+
 /******************************************************************************
  * Set the flag telling whether or not the Hough Transform for segment detection is activated
  *
@@ -33,6 +33,9 @@
 #include <vector>
 #include <string>
 
+// Project
+#include "Algorithm.h"
+
 /******************************************************************************
  ************************* DEFINE AND CONSTANT SECTION ************************
  ******************************************************************************/
@@ -76,6 +79,9 @@ public:
         eGlobalThreshold = 0,
         eLocalThreshold,
         eHysteresisThreshold,
+        eOtsuThreshold,
+        eEntropyThreshold,
+        eOtsuHysteresisThreshold,
         eUserDefinedThreshold,
         eNbThresholdTypes
     };
@@ -113,6 +119,16 @@ public:
         eNbDirectionalFilteringTypes
     };
 
+    /**
+     * Edge closure types
+     */
+    enum EdgeClosureType
+    {
+        eGradientEdgeClosure = 0,
+        eEndpointEdgeClosure,
+        eNbEdgeClosureTypes
+    };
+
     /******************************* ATTRIBUTES *******************************/
 
 	/******************************** METHODS *********************************/
@@ -222,6 +238,20 @@ public:
      */
     void setNormType( NormType pValue );
 
+    /**
+     * Get the flag telling whether or not to approximate the square root of the L2 norm
+     *
+     * @return the flag telling whether or not to approximate the square root of the L2 norm
+     */
+    bool useFastL2Norm() const;
+
+    /**
+     * Set the flag telling whether or not to approximate the square root of the L2 norm
+     *
+     * @param pFlag the flag telling whether or not to approximate the square root of the L2 norm
+     */
+    void setUseFastL2Norm( bool pFlag );
+
     /**
      * Get the gradient module
      *
@@ -301,6 +331,41 @@ public:
      */
     void setUseLocalExtrema( bool pFlag );
 
+    /**
+     * Get the flag telling whether or not to interpolate neighbors along the gradient direction to extract local extrema
+     *
+     * @return the flag telling whether or not to interpolate neighbors to extract local extrema
+     */
+    bool useInterpolatedLocalExtrema() const;
+
+    /**
+     * Set the flag telling whether or not to interpolate neighbors along the gradient direction to extract local extrema
+     *
+     * @param pFlag the flag telling whether or not to interpolate neighbors to extract local extrema
+     */
+    void setUseInterpolatedLocalExtrema( bool pFlag );
+
+    /**
+     * Set the flag telling whether or not to suppress isolated points after threshold
+     *
+     * @param pFlag a flag telling whether or not to suppress isolated points after threshold
+     */
+    void setUseIsolatedPointsSuppression( bool pFlag );
+
+    /**
+     * Get the size of the ring neighborhood used to suppress isolated points
+     *
+     * @return the size of the ring neighborhood used to suppress isolated points
+     */
+    int getIsolatedPointsRingSize() const;
+
+    /**
+     * Set the size of the ring neighborhood used to suppress isolated points
+     *
+     * @param pValue the size of the ring neighborhood used to suppress isolated points
+     */
+    void setIsolatedPointsRingSize( int pValue );
+
     /**
      * Set the flag telling whether or not to use edge extraction
      *
@@ -315,6 +380,48 @@ public:
      */
     void setUseEdgeClosure( bool pFlag );
 
+    /**
+     * Get the edge closure type
+     *
+     * @return the edge closure type
+     */
+    EdgeClosureType getEdgeClosureType() const;
+
+    /**
+     * Set the edge closure type
+     *
+     * @param pValue the edge closure type
+     */
+    void setEdgeClosureType( EdgeClosureType pValue );
+
+    /**
+     * Set the flag telling whether or not to approximate edges by polylines
+     *
+     * @param pFlag the flag telling whether or not to approximate edges by polylines
+     */
+    void setUsePolygonalApproximation( bool pFlag );
+
+    /**
+     * Get the tolerance of the polygonal approximation (max distance between an edge pixel and its segment)
+     *
+     * @return the tolerance of the polygonal approximation
+     */
+    float getPolygonalApproximationTolerance() const;
+
+    /**
+     * Set the tolerance of the polygonal approximation (max distance between an edge pixel and its segment)
+     *
+     * @param pValue the tolerance of the polygonal approximation
+     */
+    void setPolygonalApproximationTolerance( float pValue );
+
+    /**
+     * Get the polylines approximating the edges of the last processed image
+     *
+     * @return the polylines
+     */
+    const algorithm::Polylines& getPolylines() const;
+
     /**
      * Get the percentage of valid pixels for the Global Thresholding method
      *
@@ -334,7 +441,7 @@ public:
      *
      * @return the threshold compuped by Global Thresholding method
      */
-    int getGlobalThresholdValue() const;
+    float getGlobalThresholdValue() const;
 
     /**
      * Get the window size used by Local Thresholding method
@@ -350,6 +457,34 @@ public:
      */
     void setLocalThresholdWindowSize( int pValue );
 
+    /**
+     * Get the threshold used by the User Defined Thresholding method
+     *
+     * @return the threshold used by the User Defined Thresholding method
+     */
+    int getUserDefinedThresholdValue() const;
+
+    /**
+     * Set the threshold used by the User Defined Thresholding method
+     *
+     * @param pValue the threshold used by the User Defined Thresholding method
+     */
+    void setUserDefinedThresholdValue( int pValue );
+
+    /**
+     * Get the number of bins of the histograms used by Thresholding methods
+     *
+     * @return the number of bins of the histograms used by Thresholding methods
+     */
+    int getThresholdHistogramNbBins() const;
+
+    /**
+     * Set the number of bins of the histograms used by Thresholding methods
+     *
+     * @param pValue the number of bins of the histograms used by Thresholding methods
+     */
+    void setThresholdHistogramNbBins( int pValue );
+
     /**
      * Get the HIGH percentage of valid pixels used by the Hysteresis Thresholding method
      *
@@ -369,7 +504,7 @@ public:
      *
      * @return the HIGH threshold value computed by the Hysteresis Thresholding method
      */
-    int getHysteresisThresholdHighValue() const;
+    float getHysteresisThresholdHighValue() const;
 
     /**
      * Get the LOW percentage of valid pixels used by the Hysteresis Thresholding method
@@ -390,7 +525,70 @@ public:
      *
      * @return the LOW threshold value computed by the Hysteresis Thresholding method
      */
-    int getHysteresisThresholdLowValue() const;
+    float getHysteresisThresholdLowValue() const;
+
+    /**
+     * Get the flag telling whether or not to process the hysteresis threshold with bands of lines in parallel
+     *
+     * @return the flag telling whether or not to process the hysteresis threshold in parallel
+     */
+    bool useParallelHysteresis() const;
+
+    /**
+     * Set the flag telling whether or not to process the hysteresis threshold with bands of lines in parallel
+     *
+     * @param pFlag the flag telling whether or not to process the hysteresis threshold in parallel
+     */
+    void setUseParallelHysteresis( bool pFlag );
+
+    /**
+     * Get the flag telling whether or not to extract edges with connected components traced in parallel
+     *
+     * @return the flag telling whether or not to extract edges in parallel
+     */
+    bool useParallelEdgeExtraction() const;
+
+    /**
+     * Set the flag telling whether or not to extract edges with connected components traced in parallel
+     *
+     * @param pFlag the flag telling whether or not to extract edges in parallel
+     */
+    void setUseParallelEdgeExtraction( bool pFlag );
+
+    /**
+     * Get the min length (in pixels) of an edge, shorter edges are dropped during edge extraction
+     *
+     * @return the min length of an edge
+     */
+    int getEdgeMinLength() const;
+
+    /**
+     * Set the min length (in pixels) of an edge, shorter edges are dropped during edge extraction
+     *
+     * @param pValue the min length of an edge
+     */
+    void setEdgeMinLength( int pValue );
+
+    /**
+     * Get the min contrast (mean module) of an edge, edges of lower contrast are dropped during edge extraction
+     *
+     * @return the min contrast of an edge
+     */
+    float getEdgeMinContrast() const;
+
+    /**
+     * Set the min contrast (mean module) of an edge, edges of lower contrast are dropped during edge extraction
+     *
+     * @param pValue the min contrast of an edge
+     */
+    void setEdgeMinContrast( float pValue );
+
+    /**
+     * Get the edges of the last processed image, with their statistics (length, mean module, bounding box, closed flag)
+     *
+     * @return the list of edges
+     */
+    const algorithm::EdgeList& getEdges() const;
 
     /**
      * Get the flag to tell whether or not to display images in binary mode
@@ -420,6 +618,20 @@ public:
      */
     void setEdgeClosureNbIterations( unsigned int pValue );
 
+    /**
+     * Get the max gap (in pixels) between linked ends when edges are linked by their ends
+     *
+     * @return the max gap between linked ends
+     */
+    unsigned int getEdgeClosureMaxDistance() const;
+
+    /**
+     * Set the max gap (in pixels) between linked ends when edges are linked by their ends
+     *
+     * @param pValue the max gap between linked ends
+     */
+    void setEdgeClosureMaxDistance( unsigned int pValue );
+
     /**
      * Set the flag telling whether or not the Hough Transform for segment detection is activated
      *
@@ -520,6 +732,21 @@ protected:
      */
     bool _useLocalExtrema;
 
+    /**
+     * Flag telling whether or not to interpolate neighbors along the gradient direction to extract local extrema
+     */
+    bool _useInterpolatedLocalExtrema;
+
+    /**
+     * Flag telling whether or not to suppress isolated points after threshold
+     */
+    bool _useIsolatedPointsSuppression;
+
+    /**
+     * Size of the ring neighborhood used to suppress isolated points
+     */
+    int _isolatedPointsRingSize;
+
     /**
      * Flag telling whether or not to use Threhold during the process
      */
@@ -546,11 +773,36 @@ protected:
     cv::Mat _kernelDirection[ 4 ];
     cv::Mat _module;
     cv::Mat _moduleThreshold;
-    cv::Mat _pente;
+    cv::Mat _moduleIsolatedPoints;
+    cv::Mat _direction;
     cv::Mat _penteColor;
     cv::Mat _localExtrema;
     cv::Mat _edges;
 
+    /**
+     * Buffers of the hysteresis threshold (classes of pixels and flood fill stack), kept between images
+     */
+    cv::Mat _hysteresisClasses;
+    std::vector< int > _hysteresisStack;
+
+    /**
+     * Sparse list of edge pixels of the local extrema
+     * - used by the stages following the non maximum suppression (Hough transforms, edges)
+     */
+    algorithm::EdgePixels _edgePixels;
+
+    /**
+     * List of edges (Freeman codes) extracted from the local extrema
+     * - its memory is kept between images
+     */
+    algorithm::EdgeList _listEdges;
+
+    /**
+     * Polylines approximating the edges
+     * - its memory is kept between images
+     */
+    algorithm::Polylines _polylines;
+
     /**
      * Flag telling whether or not to visualize the input image
      */
@@ -566,6 +818,11 @@ protected:
      */
     NormType _normType;
 
+    /**
+     * Flag telling whether or not to approximate the square root of the L2 norm
+     */
+    bool _useFastL2Norm;
+
     /**
      * Flag telling whether or not to visualize the threshold results
      */
@@ -581,6 +838,16 @@ protected:
      */
     bool _useEdgeClosure;
 
+    /**
+     * Flag telling whether or not to approximate edges by polylines during the pipeline process
+     */
+    bool _usePolygonalApproximation;
+
+    /**
+     * Tolerance of the polygonal approximation (max distance between an edge pixel and its segment)
+     */
+    float _polygonalApproximationTolerance;
+
     /**
      * Flag telling whether or not to visualize the edges generated during the pipeline process
      */
@@ -597,21 +864,53 @@ protected:
     int _localThresholdWindowSize;
     int _hysteresisThresholdHighValidPixelPercentage;
     int _hysteresisThresholdLowValidPixelPercentage;
+    int _userDefinedThresholdValue;
+    int _thresholdHistogramNbBins;
     // Threshold computed values
-    int _globalThresholdValue;
-    int _hysteresisThresholdHighValue;
-    int _hysteresisThresholdLowValue;
+    float _globalThresholdValue;
+    float _hysteresisThresholdHighValue;
+    float _hysteresisThresholdLowValue;
+
+    /**
+     * Flag telling whether or not to process the hysteresis threshold with bands of lines in parallel
+     */
+    bool _useParallelHysteresis;
+
+    /**
+     * Flag telling whether or not to extract edges with connected components traced in parallel
+     */
+    bool _useParallelEdgeExtraction;
+
+    /**
+     * Min length (in pixels) of an edge, shorter edges are dropped during edge extraction
+     */
+    int _edgeMinLength;
+
+    /**
+     * Min contrast (mean module) of an edge, edges of lower contrast are dropped during edge extraction
+     */
+    float _edgeMinContrast;
 
     /**
      * Flag to tell whether or not to display images in binary mode
      */
     bool _useBinaryDisplay;
 
+    /**
+     * Edge closure type
+     */
+    EdgeClosureType _edgeClosureType;
+
     /**
      * Number of iterations used during the Edge Closure algorithm
      */
     unsigned int _edgeClosureNbIterations;
 
+    /**
+     * Max gap (in pixels) between linked ends when edges are linked by their ends
+     */
+    unsigned int _edgeClosureMaxDistance;
+
     /**
      * Flag telling whether or not the Hough Transform for segment detection is activated
      */
@@ -0,0 +1,210 @@
+/*
+ * Image processing : edge detection
+ *
+ * Authors : Pascal Guehl, Clement Picq
+ */
+
+/**
+ * @version 1.0
+ */
+
+ /******************************************************************************
+ ******************************* INCLUDE SECTION ******************************
+ ******************************************************************************/
+
+// System
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// Project
+#include "Convolution.h"
+
+/******************************************************************************
+ ****************************** NAMESPACE SECTION *****************************
+ ******************************************************************************/
+
+using namespace std;
+
+/******************************************************************************
+ ************************* DEFINE AND CONSTANT SECTION ************************
+ ******************************************************************************/
+
+namespace
+{
+
+/**
+ * Widths of the tested lines
+ * - all widths up to 2 vectors of 16 floats plus tails, then a few image sizes
+ */
+const int cMaxSmallWidth = 67;
+const int cLargeWidths[] = { 255, 256, 257, 640, 1021 };
+const int cNbLargeWidths = sizeof( cLargeWidths ) / sizeof( cLargeWidths[ 0 ] );
+
+/**
+ * Number of tested operations (row kernels and line operations)
+ */
+const int cNbOperations = 7;
+
+/**
+ * Value written in output lines before a convolution, to detect pixels written out of [1,width-2]
+ */
+const float cSentinel = -12345.0f;
+
+/******************************************************************************
+ ***************************** TYPE DEFINITION ********************************
+ ******************************************************************************/
+
+/**
+ * Input lines and kernels of a test
+ */
+struct TestData
+{
+    vector< float > _row0;
+    vector< float > _row1;
+    vector< float > _row2;
+    float _kernel[ 9 ];
+};
+
+/******************************************************************************
+ ***************************** METHOD DEFINITION ******************************
+ ******************************************************************************/
+
+/******************************************************************************
+ * Random value in [-pRange,pRange], with a fractional part so that rounding matters
+ *
+ * @param pRange range of values
+ *
+ * @return a random value
+ ******************************************************************************/
+float getRandomValue( float pRange )
+{
+    return pRange * ( 2.0f * static_cast< float >( rand() ) / static_cast< float >( RAND_MAX ) - 1.0f );
+}
+
+/******************************************************************************
+ * Fill input lines and kernel with random values
+ *
+ * @param pWidth number of pixels of a line
+ * @param pData test data
+ ******************************************************************************/
+void initialize( int pWidth, TestData& pData )
+{
+    pData._row0.resize( pWidth );
+    pData._row1.resize( pWidth );
+    pData._row2.resize( pWidth );
+    for ( int y = 0; y < pWidth; y++ )
+    {
+        pData._row0[ y ] = getRandomValue( 255.0f );
+        pData._row1[ y ] = getRandomValue( 255.0f );
+        pData._row2[ y ] = getRandomValue( 255.0f );
+    }
+    for ( int i = 0; i < 9; i++ )
+    {
+        pData._kernel[ i ] = getRandomValue( 2.0f );
+    }
+}
+
+/******************************************************************************
+ * Run the row kernels and line operations with the current backend
+ *
+ * @param pData test data
+ * @param pWidth number of pixels of a line
+ * @param pOutputs output lines (one per row kernel or line operation)
+ ******************************************************************************/
+void run( const TestData& pData, int pWidth, vector< float >* pOutputs )
+{
+    for ( int i = 0; i < cNbOperations; i++ )
+    {
+        pOutputs[ i ].assign( pWidth, cSentinel );
+    }
+
+    Convolution::filterRow( &pData._row0[ 0 ], &pData._row1[ 0 ], &pData._row2[ 0 ], pData._kernel, &pOutputs[ 0 ][ 0 ], pWidth );
+    Convolution::filterRowHorizontal( &pData._row1[ 0 ], pData._kernel, &pOutputs[ 1 ][ 0 ], pWidth );
+    Convolution::filterRowVertical( &pData._row0[ 0 ], &pData._row1[ 0 ], &pData._row2[ 0 ], pData._kernel + 3, &pOutputs[ 2 ][ 0 ], pWidth );
+    Convolution::subtractRows( &pData._row0[ 0 ], &pData._row2[ 0 ], &pOutputs[ 3 ][ 0 ], pWidth );
+    Convolution::addRows( &pData._row0[ 0 ], &pData._row2[ 0 ], &pOutputs[ 4 ][ 0 ], pWidth );
+    Convolution::scaleRow( &pData._row1[ 0 ], pData._kernel[ 0 ], &pOutputs[ 5 ][ 0 ], pWidth );
+
+    // Linear combination of lines
+    pOutputs[ 6 ] = pData._row2;
+    Convolution::accumulateRow( &pData._row0[ 0 ], pData._kernel[ 1 ], &pOutputs[ 6 ][ 0 ], pWidth );
+    Convolution::accumulateRow( &pData._row1[ 0 ], pData._kernel[ 2 ], &pOutputs[ 6 ][ 0 ], pWidth );
+}
+
+/******************************************************************************
+ * Compare a backend to the scalar reference on a line
+ *
+ * @param pBackend the backend to test
+ * @param pWidth number of pixels of a line
+ *
+ * @return the number of mismatching operations
+ ******************************************************************************/
+int test( Convolution::Backend pBackend, int pWidth )
+{
+    static const char* const operationNames[ cNbOperations ] = { "filterRow", "filterRowHorizontal", "filterRowVertical", "subtractRows", "addRows", "scaleRow", "accumulateRow" };
+
+    TestData data;
+    initialize( pWidth, data );
+
+    vector< float > references[ cNbOperations ];
+    Convolution::setBackend( Convolution::eScalarBackend );
+    run( data, pWidth, references );
+
+    vector< float > outputs[ cNbOperations ];
+    Convolution::setBackend( pBackend );
+    run( data, pWidth, outputs );
+
+    // Bit for bit comparison (sentinels included)
+    int nbErrors = 0;
+    for ( int i = 0; i < cNbOperations; i++ )
+    {
+        if ( memcmp( &references[ i ][ 0 ], &outputs[ i ][ 0 ], pWidth * sizeof( float ) ) != 0 )
+        {
+            cout << "ERROR : " << Convolution::getBackendName( pBackend ) << " " << operationNames[ i ] << " differs from scalar (width " << pWidth << ")" << endl;
+            nbErrors++;
+        }
+    }
+
+    return nbErrors;
+}
+
+}
+
+/******************************************************************************
+ * Main entry program
+ *
+ * @param pArgc number of arguments
+ * @param pArgv list of arguments
+ *
+ * @return exit code
+ ******************************************************************************/
+int main( int /*pArgc*/, char** /*pArgv*/ )
+{
+    srand( 0 );
+
+    const Convolution::Backend supportedBackend = Convolution::getSupportedBackend();
+    cout << "Supported backend : " << Convolution::getBackendName( supportedBackend ) << endl;
+
+    int nbErrors = 0;
+    for ( int backend = Convolution::eSSE41Backend; backend <= supportedBackend; backend++ )
+    {
+        const Convolution::Backend currentBackend = static_cast< Convolution::Backend >( backend );
+
+        for ( int width = 3; width <= cMaxSmallWidth; width++ )
+        {
+            nbErrors += test( currentBackend, width );
+        }
+        for ( int i = 0; i < cNbLargeWidths; i++ )
+        {
+            nbErrors += test( currentBackend, cLargeWidths[ i ] );
+        }
+
+        cout << "- " << Convolution::getBackendName( currentBackend ) << " tested" << endl;
+    }
+
+    cout << ( ( nbErrors == 0 ) ? "PASSED" : "FAILED" ) << endl;
+
+    return ( nbErrors == 0 ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,16 @@
+# Check that the SIMD convolution backends (row kernels and line operations) match the scalar reference bit for bit
+
+TARGET = ConvolutionTest
+CONFIG += console
+CONFIG -= app_bundle
+CONFIG -= qt
+
+TEMPLATE = app
+
+INCLUDEPATH += ..
+
+SOURCES += ConvolutionTest.cpp \
+    ../Convolution.cpp
+
+HEADERS += \
+    ../Convolution.h